@@ -10,12 +10,15 @@
 
 // Slate
 #include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Input/SNumericEntryBox.h"
+#include "Widgets/Notifications/SProgressBar.h"
 #include "PropertyCustomizationHelpers.h"
 #include "Selection.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Framework/Docking/TabManager.h"
+#include "ScopedTransaction.h"
 
 const FName UGenerationWindow::TabName(TEXT("ProceduralGenerationTab"));
 TWeakObjectPtr<AActor> UGenerationWindow::TargetActor = nullptr;
@@ -40,6 +43,11 @@ void UGenerationWindow::SetTargetActor(AActor* Actor)
     TargetActor = Actor;
 }
 
+UProceduralPlacementComponent* UGenerationWindow::GetTargetComponent()
+{
+    return TargetActor.IsValid() ? TargetActor->FindComponentByClass<UProceduralPlacementComponent>() : nullptr;
+}
+
 TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
 {
     return SNew(SDockTab)
@@ -119,7 +127,11 @@ TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
                     if (TargetActor.IsValid())
                     {
                         UProceduralPlacementComponent* Comp = TargetActor->FindComponentByClass<UProceduralPlacementComponent>();
-                        if (Comp) Comp->Mesh = Cast<UStaticMesh>(NewAsset.GetAsset());
+                        if (Comp)
+                        {
+                            Comp->Mesh = Cast<UStaticMesh>(NewAsset.GetAsset());
+                            Comp->RequestPreview();
+                        }
                     }
                 })
             ]
@@ -173,7 +185,11 @@ TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
                     if (TargetActor.IsValid())
                     {
                         UProceduralPlacementComponent* Comp = TargetActor->FindComponentByClass<UProceduralPlacementComponent>();
-                        if (Comp) Comp->Spacing = NewValue;
+                        if (Comp)
+                        {
+                            Comp->Spacing = NewValue;
+                            Comp->RequestPreview();
+                        }
                     }
                 })
             ]
@@ -200,7 +216,11 @@ TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
                     if (TargetActor.IsValid())
                     {
                         UProceduralPlacementComponent* Comp = TargetActor->FindComponentByClass<UProceduralPlacementComponent>();
-                        if (Comp) Comp->Seed = NewValue;
+                        if (Comp)
+                        {
+                            Comp->Seed = NewValue;
+                            Comp->RequestPreview();
+                        }
                     }
                 })
             ]
@@ -217,13 +237,143 @@ TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
                         UProceduralPlacementComponent* Comp = TargetActor->FindComponentByClass<UProceduralPlacementComponent>();
                         if (Comp)
                         {
-                            Comp->Generate(); 
+                            // Records the parameters and the key of the points, not the instances
+                            FScopedTransaction Transaction(FText::FromString("Generate Placement"));
+                            Comp->Modify();
+                            Comp->Generate();
                         }
                     }
                     return FReply::Handled();
                 })
             ]
 
+            // Live preview, spline edits resample in the background and Commit builds the instances
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(5)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.f)
+                .VAlign(VAlign_Center)
+                [
+                    SNew(SCheckBox)
+                    .IsChecked_Lambda([]() -> ECheckBoxState
+                    {
+                        UProceduralPlacementComponent* Comp = GetTargetComponent();
+                        return Comp && Comp->IsLivePreviewActive() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+                    })
+                    .OnCheckStateChanged_Lambda([](ECheckBoxState NewState)
+                    {
+                        if (UProceduralPlacementComponent* Comp = GetTargetComponent())
+                        {
+                            if (NewState == ECheckBoxState::Checked)
+                            {
+                                Comp->StartLivePreview();
+                            }
+                            else
+                            {
+                                Comp->StopLivePreview();
+                            }
+                        }
+                    })
+                    [
+                        SNew(STextBlock)
+                        .Text(FText::FromString("Live Preview"))
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                [
+                    SNew(SButton)
+                    .Text(FText::FromString("Commit"))
+                    .IsEnabled_Lambda([]() -> bool
+                    {
+                        UProceduralPlacementComponent* Comp = GetTargetComponent();
+                        return Comp && Comp->IsLivePreviewActive();
+                    })
+                    .OnClicked_Lambda([]() -> FReply
+                    {
+                        if (UProceduralPlacementComponent* Comp = GetTargetComponent())
+                        {
+                            FScopedTransaction Transaction(FText::FromString("Commit Placement Preview"));
+                            Comp->Modify();
+                            Comp->CommitPreview();
+                        }
+                        return FReply::Handled();
+                    })
+                ]
+            ]
+
+            // Progress
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(5)
+            [
+                SNew(SHorizontalBox)
+                .Visibility_Lambda([]() -> EVisibility
+                {
+                    UProceduralPlacementComponent* Comp = GetTargetComponent();
+                    return Comp && Comp->IsGenerating() ? EVisibility::Visible : EVisibility::Collapsed;
+                })
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.f)
+                .VAlign(VAlign_Center)
+                .Padding(0, 0, 5, 0)
+                [
+                    SNew(SProgressBar)
+                    .Percent_Lambda([]() -> TOptional<float>
+                    {
+                        UProceduralPlacementComponent* Comp = GetTargetComponent();
+                        return Comp ? Comp->GetGenerationProgress() : 0.f;
+                    })
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                [
+                    SNew(SButton)
+                    .Text(FText::FromString("Cancel"))
+                    .OnClicked_Lambda([]() -> FReply
+                    {
+                        if (UProceduralPlacementComponent* Comp = GetTargetComponent())
+                        {
+                            Comp->CancelGeneration();
+                        }
+                        return FReply::Handled();
+                    })
+                ]
+            ]
+
+            // Last generation report
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(5)
+            [
+                SNew(STextBlock)
+                .AutoWrapText(true)
+                .Visibility_Lambda([]() -> EVisibility
+                {
+                    UProceduralPlacementComponent* Comp = GetTargetComponent();
+                    if (!Comp)
+                    {
+                        return EVisibility::Collapsed;
+                    }
+
+                    // Point cache hits sample nothing, their report still has the load and submit timings
+                    const FPlacementGenerationReport& Report = Comp->GetLastReport();
+                    return Report.NumSampledPoints > 0 || Report.bFromPointCache ? EVisibility::Visible : EVisibility::Collapsed;
+                })
+                .Text_Lambda([]() -> FText
+                {
+                    UProceduralPlacementComponent* Comp = GetTargetComponent();
+                    return Comp ? FText::FromString(Comp->GetLastReport().ToString()) : FText::GetEmpty();
+                })
+            ]
+
             // Clear Meshes
             + SVerticalBox::Slot()
             .AutoHeight()
@@ -236,9 +386,12 @@ TSharedRef<SDockTab> UGenerationWindow::SpawnTab(const FSpawnTabArgs& Args)
                     if (TargetActor.IsValid())
                     {
                         UProceduralPlacementComponent* Comp = TargetActor->FindComponentByClass<UProceduralPlacementComponent>();
-                        if (Comp && Comp->Spline->ISMComp)
+                        if (Comp)
                         {
-                            Comp->Spline->ISMComp->ClearInstances(); 
+                            FScopedTransaction Transaction(FText::FromString("Clear Placement"));
+                            Comp->Modify();
+                            Comp->CancelGeneration();
+                            Comp->ClearInstances();
                         }
                     }
                     return FReply::Handled();
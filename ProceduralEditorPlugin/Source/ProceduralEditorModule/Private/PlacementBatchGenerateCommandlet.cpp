@@ -0,0 +1,257 @@
+#include "PlacementBatchGenerateCommandlet.h"
+#include "ProceduralPlacementComponent.h"
+#include "PlacementPointCache.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPlacementBatchGenerate, Log, All);
+
+namespace PlacementBatchGenerate
+{
+    struct FZone
+    {
+        UProceduralPlacementComponent* Component = nullptr;
+        TArray<FVector> Points;
+        FString CacheKey;
+        bool bFromPointCache = false;
+        // Rank of the zone's LayerOrder in its layer group, zones of one pass sample together
+        int32 Pass = 0;
+        double CacheSeconds = 0.0;
+        double SampleSeconds = 0.0;
+        double ProjectSeconds = 0.0;
+        double SubmitSeconds = 0.0;
+    };
+}
+
+UPlacementBatchGenerateCommandlet::UPlacementBatchGenerateCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPlacementBatchGenerateCommandlet::Main(const FString& Params)
+{
+    FString MapList;
+    if (!FParse::Value(*Params, TEXT("Map="), MapList, false))
+    {
+        UE_LOG(LogPlacementBatchGenerate, Error, TEXT("Usage: -run=PlacementBatchGenerate -Map=/Game/Maps/A[,/Game/Maps/B] [-NoSave]"));
+        return 1;
+    }
+
+    const bool bSave = !FParse::Param(*Params, TEXT("NoSave"));
+
+    TArray<FString> Maps;
+    MapList.ParseIntoArray(Maps, TEXT(","));
+
+    int32 NumFailed = 0;
+    for (const FString& Map : Maps)
+    {
+        if (!ProcessMap(Map, bSave))
+        {
+            NumFailed++;
+        }
+    }
+
+    return NumFailed > 0 ? 1 : 0;
+}
+
+UWorld* UPlacementBatchGenerateCommandlet::LoadWorld(const FString& MapPath)
+{
+    UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Editor;
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+    WorldContext.SetCurrentWorld(World);
+
+    // Physics is needed for the projection traces, no audio or navigation
+    if (!World->bIsWorldInitialized)
+    {
+        World->InitWorld(UWorld::InitializationValues()
+            .AllowAudioPlayback(false)
+            .CreatePhysicsScene(true)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .ShouldSimulatePhysics(false)
+            .EnableTraceCollision(true));
+    }
+    World->UpdateWorldComponents(true, true);
+
+    return World;
+}
+
+void UPlacementBatchGenerateCommandlet::UnloadWorld(UWorld* World)
+{
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+    CollectGarbage(RF_NoFlags);
+}
+
+bool UPlacementBatchGenerateCommandlet::ProcessMap(const FString& MapPath, bool bSave)
+{
+    using namespace PlacementBatchGenerate;
+
+    const double MapStart = FPlatformTime::Seconds();
+
+    UWorld* World = LoadWorld(MapPath);
+    if (!World)
+    {
+        UE_LOG(LogPlacementBatchGenerate, Error, TEXT("Could not load %s"), *MapPath);
+        return false;
+    }
+
+    TArray<FZone> Zones;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        TArray<UProceduralPlacementComponent*> Components;
+        It->GetComponents(Components);
+
+        for (UProceduralPlacementComponent* Component : Components)
+        {
+            if (Component->HasMesh() && Component->Spline && Component->Spline->GetNumberOfSplinePoints() >= 3)
+            {
+                Zones.AddDefaulted_GetRef().Component = Component;
+            }
+            else
+            {
+                UE_LOG(LogPlacementBatchGenerate, Warning, TEXT("%s: skipped, no mesh or no closed spline"), *GetNameSafe(*It));
+            }
+        }
+    }
+
+    UE_LOG(LogPlacementBatchGenerate, Display, TEXT("%s: %d zones"), *MapPath, Zones.Num());
+
+    // A zone of a layer group samples around the points of its lower layers, so zones run
+    // in passes by their rank in the group. Zones without a group all go in the first pass.
+    int32 NumPasses = 1;
+    for (FZone& Zone : Zones)
+    {
+        const UProceduralPlacementComponent* Component = Zone.Component;
+        TSet<int32> LowerOrders;
+
+        if (!Component->LayerGroup.IsNone())
+        {
+            for (const FZone& Other : Zones)
+            {
+                if (Other.Component->LayerGroup == Component->LayerGroup && Other.Component->LayerOrder < Component->LayerOrder)
+                {
+                    LowerOrders.Add(Other.Component->LayerOrder);
+                }
+            }
+        }
+
+        Zone.Pass = LowerOrders.Num();
+        NumPasses = FMath::Max(NumPasses, Zone.Pass + 1);
+    }
+
+    TSet<UPackage*> Packages;
+    Packages.Add(World->GetPackage());
+
+    for (int32 Pass = 0; Pass < NumPasses; Pass++)
+    {
+        TArray<FZone*> PassZones;
+        for (FZone& Zone : Zones)
+        {
+            if (Zone.Pass == Pass)
+            {
+                PassZones.Add(&Zone);
+            }
+        }
+
+        // Reads spline and landscape components, game thread only
+        for (FZone* Zone : PassZones)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Zone->Component->CancelGeneration();
+            Zone->Component->CacheSpline();
+            Zone->Component->PrepareProjection();
+            Zone->Component->GeneratedPointsKey = Zone->Component->GetInputsKey();
+            Zone->CacheKey = Zone->Component->bUsePointCache ? Zone->Component->GeneratedPointsKey : FString();
+            Zone->bFromPointCache = !Zone->CacheKey.IsEmpty() && FPlacementPointCache::Load(Zone->CacheKey, Zone->Points);
+            Zone->CacheSeconds = FPlatformTime::Seconds() - Start;
+        }
+
+        // Zones only read their own data, the layer index and the physics scene
+        ParallelFor(PassZones.Num(), [&PassZones](int32 Index)
+        {
+            FZone& Zone = *PassZones[Index];
+            if (Zone.bFromPointCache)
+            {
+                return;
+            }
+
+            double Start = FPlatformTime::Seconds();
+            Zone.Component->PoissonDiskAlgo(Zone.Points);
+            Zone.SampleSeconds = FPlatformTime::Seconds() - Start;
+
+            Start = FPlatformTime::Seconds();
+            Zone.Component->ProjectPointArray(Zone.Points);
+            Zone.Component->OrderPointsProgressive(Zone.Points);
+            Zone.ProjectSeconds = FPlatformTime::Seconds() - Start;
+
+            if (!Zone.CacheKey.IsEmpty())
+            {
+                FPlacementPointCache::Save(Zone.CacheKey, Zone.Points);
+            }
+        });
+
+        for (FZone* Zone : PassZones)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Zone->Component->Positions = MoveTemp(Zone->Points);
+            Zone->Component->PrepareInstanceComponent();
+            Zone->Component->SubmitInstances();
+            Zone->SubmitSeconds = FPlatformTime::Seconds() - Start;
+
+            // Actors saved in their own package with one file per actor
+            AActor* Owner = Zone->Component->GetOwner();
+            Owner->MarkPackageDirty();
+            Packages.Add(Owner->GetPackage());
+
+            UE_LOG(LogPlacementBatchGenerate, Display, TEXT("  %-40s %8d instances%s  cache %7.1f ms  sample %8.1f ms  project %8.1f ms  submit %7.1f ms"),
+                *Owner->GetActorNameOrLabel(), Zone->Component->Positions.Num(), Zone->bFromPointCache ? TEXT(" (cached)") : TEXT(""),
+                Zone->CacheSeconds * 1000.0, Zone->SampleSeconds * 1000.0, Zone->ProjectSeconds * 1000.0, Zone->SubmitSeconds * 1000.0);
+        }
+    }
+
+    bool bSucceeded = true;
+    if (bSave)
+    {
+        for (UPackage* Package : Packages)
+        {
+            const FString Extension = Package == World->GetPackage() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+            const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), Extension);
+
+            FSavePackageArgs SaveArgs;
+            SaveArgs.TopLevelFlags = RF_Standalone;
+            SaveArgs.Error = GError;
+
+            if (!UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs))
+            {
+                UE_LOG(LogPlacementBatchGenerate, Error, TEXT("Could not save %s"), *Filename);
+                bSucceeded = false;
+            }
+        }
+    }
+
+    UE_LOG(LogPlacementBatchGenerate, Display, TEXT("%s: done in %.2f s"), *MapPath, FPlatformTime::Seconds() - MapStart);
+
+    UnloadWorld(World);
+    return bSucceeded;
+}
@@ -0,0 +1,274 @@
+#include "PlacementBenchmarkCommandlet.h"
+#include "ProceduralPlacementComponent.h"
+#include "SplineActor.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPlacementBenchmark, Log, All);
+
+namespace PlacementBenchmark
+{
+    // Density assumed when sizing a zone for a target point count
+    constexpr double PointsPerSpacingSquared = 0.75;
+
+    constexpr int32 MaxInsideQueries = 1000000;
+
+    TArray<int32> ParseIntList(const FString& Params, const TCHAR* Key, const TArray<int32>& Default)
+    {
+        FString Value;
+        if (!FParse::Value(*Params, Key, Value, false))
+        {
+            return Default;
+        }
+
+        TArray<FString> Entries;
+        Value.ParseIntoArray(Entries, TEXT(","));
+
+        TArray<int32> Result;
+        for (const FString& Entry : Entries)
+        {
+            Result.Add(FCString::Atoi(*Entry));
+        }
+        return Result;
+    }
+
+    double UsedMemoryMB()
+    {
+        return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+    }
+
+    // PeakUsedPhysical covers the whole process lifetime, so each case keeps its own
+    // peak of the used memory sampled between stages, relative to where it started
+    struct FMemoryProbe
+    {
+        double StartMB = UsedMemoryMB();
+        double PeakMB = StartMB;
+
+        void Sample()
+        {
+            PeakMB = FMath::Max(PeakMB, UsedMemoryMB());
+        }
+
+        double GetPeakDeltaMB() const
+        {
+            return PeakMB - StartMB;
+        }
+    };
+}
+
+UPlacementBenchmarkCommandlet::UPlacementBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UPlacementBenchmarkCommandlet::Main(const FString& Params)
+{
+    const TArray<int32> VertexCounts = PlacementBenchmark::ParseIntList(Params, TEXT("Vertices="), { 8, 64, 1000, 10000 });
+    const TArray<int32> PointCounts  = PlacementBenchmark::ParseIntList(Params, TEXT("Points="), { 1000, 100000, 1000000, 10000000 });
+
+    float Spacing = 100.0f;
+    FParse::Value(*Params, TEXT("Spacing="), Spacing);
+
+    FString Mode = TEXT("Bridson");
+    FParse::Value(*Params, TEXT("Mode="), Mode);
+
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") /
+        FString::Printf(TEXT("PlacementBenchmark-%s.json"), *FDateTime::Now().ToString());
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+    if (!Mesh)
+    {
+        UE_LOG(LogPlacementBenchmark, Error, TEXT("Could not load the benchmark mesh"));
+        return 1;
+    }
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("PlacementBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+    WorldContext.SetCurrentWorld(World);
+
+    TArray<TSharedPtr<FJsonValue>> Results;
+    for (const int32 NumVertices : VertexCounts)
+    {
+        for (const int32 TargetPoints : PointCounts)
+        {
+            Results.Add(MakeShared<FJsonValueObject>(RunCase(World, Mesh, NumVertices, TargetPoints, Spacing, Mode)));
+        }
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Root->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    Root->SetStringField(TEXT("mode"), Mode);
+    Root->SetNumberField(TEXT("spacing"), Spacing);
+    Root->SetArrayField(TEXT("results"), Results);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogPlacementBenchmark, Error, TEXT("Could not write %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogPlacementBenchmark, Display, TEXT("Results written to %s"), *OutputPath);
+    return 0;
+}
+
+void UPlacementBenchmarkCommandlet::BuildZone(TArray<FVector>& OutPoints, int32 NumVertices, double Radius)
+{
+    OutPoints.Reset(NumVertices);
+
+    const bool bConcave = NumVertices > 16;
+    const int32 NumLobes = FMath::Max(3, NumVertices / 16);
+
+    for (int32 i = 0; i < NumVertices; i++)
+    {
+        const double Angle = UE_DOUBLE_TWO_PI * i / NumVertices;
+        const double R = bConcave ? Radius * (0.75 + 0.25 * FMath::Sin(NumLobes * Angle)) : Radius;
+        OutPoints.Add(FVector(FMath::Cos(Angle) * R, FMath::Sin(Angle) * R, 0.0));
+    }
+}
+
+// Runs every stage of the pipeline once on a fresh zone.
+// The zone is sized so that roughly TargetPoints points fit at the given spacing.
+
+TSharedRef<FJsonObject> UPlacementBenchmarkCommandlet::RunCase(UWorld* World, UStaticMesh* Mesh, int32 NumVertices, int32 TargetPoints, float Spacing, const FString& Mode)
+{
+    PlacementBenchmark::FMemoryProbe Memory;
+
+    TArray<FVector> Zone;
+    BuildZone(Zone, NumVertices, 1.0);
+
+    double UnitArea = 0.0;
+    for (int32 i = 0; i < Zone.Num(); i++)
+    {
+        const FVector& P1 = Zone[i];
+        const FVector& P2 = Zone[(i + 1) % Zone.Num()];
+        UnitArea += P1.X * P2.Y - P2.X * P1.Y;
+    }
+    UnitArea = FMath::Abs(UnitArea) * 0.5;
+
+    const double Radius = FMath::Sqrt(TargetPoints * Spacing * Spacing / PlacementBenchmark::PointsPerSpacingSquared / UnitArea);
+    BuildZone(Zone, NumVertices, Radius);
+
+    // Flat ground under the zone for the projection traces
+    AStaticMeshActor* Ground = World->SpawnActor<AStaticMeshActor>(FVector(0.0, 0.0, -100.0), FRotator::ZeroRotator);
+    Ground->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+    Ground->SetActorScale3D(FVector(Radius * 2.2 / 100.0, Radius * 2.2 / 100.0, 1.0));
+
+    ASplineActor* ZoneActor = World->SpawnActor<ASplineActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+    USplineComponentPG* Spline = ZoneActor->SplineComponent;
+    Spline->ClearSplinePoints(false);
+    for (int32 i = 0; i < Zone.Num(); i++)
+    {
+        Spline->AddSplinePoint(Zone[i], ESplineCoordinateSpace::World, false);
+        Spline->SetSplinePointType(i, ESplinePointType::Linear, false);
+    }
+    Spline->SetClosedLoop(true, false);
+    Spline->UpdateSpline();
+
+    UProceduralPlacementComponent* Comp = NewObject<UProceduralPlacementComponent>(ZoneActor);
+    Comp->RegisterComponent();
+    Comp->Mesh = Mesh;
+    Comp->Spline = Spline;
+    Comp->Spacing = Spacing;
+    Comp->bAsyncGeneration = false;
+    Comp->SamplingMode = Mode == TEXT("TiledBridson") ? EPlacementSamplingMode::TiledBridson : EPlacementSamplingMode::Bridson;
+
+    double Time = FPlatformTime::Seconds();
+    auto Lap = [&Time, &Memory]()
+    {
+        Memory.Sample();
+        const double Now = FPlatformTime::Seconds();
+        const double Elapsed = Now - Time;
+        Time = Now;
+        return Elapsed;
+    };
+
+    Comp->CacheSpline();
+    const double CacheSeconds = Lap();
+
+    TArray<FVector> Points;
+    Comp->PoissonDiskAlgo(Points);
+    const double SampleSeconds = Lap();
+
+    // Containment alone, on random points over the zone bounds
+    const int32 NumQueries = FMath::Min(FMath::Max(Points.Num(), 1000), PlacementBenchmark::MaxInsideQueries);
+    FRandomStream Random(Comp->Seed);
+    const FVector Min = Comp->GetMinPoint();
+    const FVector Max = Comp->GetMaxPoint();
+    int32 NumInside = 0;
+    Lap();
+    for (int32 i = 0; i < NumQueries; i++)
+    {
+        const FVector Query(FMath::Lerp(Min.X, Max.X, Random.FRand()), FMath::Lerp(Min.Y, Max.Y, Random.FRand()), 0.0);
+        NumInside += Comp->IsInside(Query) ? 1 : 0;
+    }
+    const double InsideSeconds = Lap();
+
+    Comp->Positions = MoveTemp(Points);
+    Comp->ProjectPoints();
+    const double ProjectSeconds = Lap();
+
+    Comp->PrepareInstanceComponent();
+    Comp->SubmitInstances();
+    const double ApplySeconds = Lap();
+
+    const int32 NumPoints = Comp->Positions.Num();
+    const double TotalSeconds = CacheSeconds + SampleSeconds + ProjectSeconds + ApplySeconds;
+
+    TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+    Stages->SetNumberField(TEXT("cacheSplineMs"), CacheSeconds * 1000.0);
+    Stages->SetNumberField(TEXT("poissonDiskMs"), SampleSeconds * 1000.0);
+    Stages->SetNumberField(TEXT("isInsideMs"), InsideSeconds * 1000.0);
+    Stages->SetNumberField(TEXT("projectPointsMs"), ProjectSeconds * 1000.0);
+    Stages->SetNumberField(TEXT("applyPointsMs"), ApplySeconds * 1000.0);
+
+    TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("vertices"), NumVertices);
+    Result->SetNumberField(TEXT("polygonVertices"), Comp->SplinePoints.Num());
+    Result->SetNumberField(TEXT("targetPoints"), TargetPoints);
+    Result->SetNumberField(TEXT("points"), NumPoints);
+    Result->SetNumberField(TEXT("zoneArea"), Comp->ZoneArea);
+    Result->SetObjectField(TEXT("stages"), Stages);
+    Result->SetNumberField(TEXT("totalMs"), TotalSeconds * 1000.0);
+    Result->SetNumberField(TEXT("pointsPerSecond"), TotalSeconds > 0.0 ? NumPoints / TotalSeconds : 0.0);
+    Result->SetNumberField(TEXT("samplingPointsPerSecond"), SampleSeconds > 0.0 ? NumPoints / SampleSeconds : 0.0);
+    Result->SetNumberField(TEXT("insideQueries"), NumQueries);
+    Result->SetNumberField(TEXT("insideQueriesPerSecond"), InsideSeconds > 0.0 ? NumQueries / InsideSeconds : 0.0);
+    Result->SetNumberField(TEXT("peakMemoryDeltaMB"), Memory.GetPeakDeltaMB());
+
+    UE_LOG(LogPlacementBenchmark, Display, TEXT("%5d vertices, %8d points: sample %.1f ms, inside %.1f ms (%d queries, %d in), project %.1f ms, apply %.1f ms, %.0f points/s"),
+        NumVertices, NumPoints, SampleSeconds * 1000.0, InsideSeconds * 1000.0, NumQueries, NumInside,
+        ProjectSeconds * 1000.0, ApplySeconds * 1000.0, TotalSeconds > 0.0 ? NumPoints / TotalSeconds : 0.0);
+
+    ZoneActor->Destroy();
+    Ground->Destroy();
+
+    // Frees this case before the next one measures its starting point
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+    return Result;
+}
@@ -45,7 +45,8 @@ public class ProceduralEditorModule : ModuleRules
                 "LevelEditor",
                  "ProceduralRuntimeModule",
                  "PropertyEditor",
-                 "InputCore"
+                 "InputCore",
+                 "Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -5,6 +5,7 @@
 #include "UObject/WeakObjectPtrTemplates.h"
 
 class ASplineActor;
+class UProceduralPlacementComponent;
 
 class UGenerationWindow
 {
@@ -15,6 +16,7 @@ public:
 
 	static FReply OnCreateProceduralActorClicked();
 	static void SetTargetActor(AActor* Actor);
+	static UProceduralPlacementComponent* GetTargetComponent();
 
 	static TWeakObjectPtr<AActor> TargetActor;
 
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlacementBatchGenerateCommandlet.generated.h"
+
+class UWorld;
+
+// Regenerates every placement zone of one or more maps without the editor UI.
+//
+// UnrealEditor-Cmd <Project> -run=PlacementBatchGenerate -nullrhi -unattended
+//     -Map=/Game/Maps/A[,/Game/Maps/B...] [-NoSave]
+//
+// Spline caching and instance submission run on the game thread, sampling and
+// projection of all zones run in parallel, one layer of each layer group at a time.
+// Timings are logged per zone, and the map and the actor packages of the generated
+// zones are saved unless -NoSave.
+UCLASS()
+class UPlacementBatchGenerateCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPlacementBatchGenerateCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    static UWorld* LoadWorld(const FString& MapPath);
+    static void UnloadWorld(UWorld* World);
+
+    // Returns false when the map could not be loaded or saved
+    static bool ProcessMap(const FString& MapPath, bool bSave);
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlacementBenchmarkCommandlet.generated.h"
+
+class FJsonObject;
+class UStaticMesh;
+
+// Headless benchmark of the placement pipeline on generated zones.
+//
+// UnrealEditor-Cmd <Project> -run=PlacementBenchmark -nullrhi -unattended
+//     [-Vertices=8,64,1000,10000] [-Points=1000,100000,1000000,10000000] [-Spacing=100]
+//     [-Mode=Bridson|TiledBridson] [-Output=<file.json>]
+//
+// Every vertex count is run at every point count. Results (per-stage timings,
+// points/sec, peak memory growth of the case) are written as JSON, by default to Saved/Benchmarks.
+UCLASS()
+class UPlacementBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPlacementBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // Closed zone of NumVertices points, convex up to 16 vertices and star shaped above
+    static void BuildZone(TArray<FVector>& OutPoints, int32 NumVertices, double Radius);
+
+    static TSharedRef<FJsonObject> RunCase(UWorld* World, UStaticMesh* Mesh, int32 NumVertices, int32 TargetPoints, float Spacing, const FString& Mode);
+};
@@ -0,0 +1,189 @@
+#include "BlueNoiseTileSet.h"
+
+namespace BlueNoiseTileSet
+{
+	// Bridson sampler with spacing 1 on a torus of side TileSize
+	struct FToroidalSampler
+	{
+		explicit FToroidalSampler(float InTileSize)
+			: TileSize(InTileSize)
+		{
+			// Cells must divide the tile exactly for the neighborhood to wrap,
+			// and stay under 1/sqrt(2) so a cell never holds two points
+			Width = FMath::CeilToInt(TileSize * UE_SQRT_2);
+			CellSize = TileSize / Width;
+			Cells.Init(INDEX_NONE, Width * Width);
+		}
+
+		bool TryAdd(const FVector2D& Point, double Margin)
+		{
+			if (Point.X < Margin || Point.Y < Margin || Point.X >= TileSize - Margin || Point.Y >= TileSize - Margin)
+			{
+				return false;
+			}
+
+			const int32 CX = FMath::Clamp(FMath::FloorToInt32(Point.X / CellSize), 0, Width - 1);
+			const int32 CY = FMath::Clamp(FMath::FloorToInt32(Point.Y / CellSize), 0, Width - 1);
+
+			for (int32 DY = -2; DY <= 2; DY++)
+			{
+				for (int32 DX = -2; DX <= 2; DX++)
+				{
+					const int32 Idx = Cells[Wrap(CY + DY) * Width + Wrap(CX + DX)];
+					if (Idx == INDEX_NONE)
+					{
+						continue;
+					}
+
+					// Shortest offset on the torus
+					FVector2D Delta = Points[Idx] - Point;
+					Delta.X -= TileSize * FMath::RoundToDouble(Delta.X / TileSize);
+					Delta.Y -= TileSize * FMath::RoundToDouble(Delta.Y / TileSize);
+					if (Delta.SizeSquared() < 1.0)
+					{
+						return false;
+					}
+				}
+			}
+
+			Cells[CY * Width + CX] = Points.Add(Point);
+			Active.Add(Point);
+			return true;
+		}
+
+		// Covers the tile, only accepting points at least Margin away from its edges
+		void Fill(double Margin, FRandomStream& Random)
+		{
+			Active.Reset();
+
+			for (int32 Y = 0; Y < Width; Y++)
+			{
+				for (int32 X = 0; X < Width; X++)
+				{
+					if (Cells[Y * Width + X] != INDEX_NONE)
+					{
+						continue;
+					}
+
+					for (int32 Attempt = 0; Attempt < 4; Attempt++)
+					{
+						if (TryAdd(FVector2D(X + Random.FRand(), Y + Random.FRand()) * CellSize, Margin))
+						{
+							break;
+						}
+					}
+
+					while (Active.Num() > 0)
+					{
+						const int32 Index = Random.RandRange(0, Active.Num() - 1);
+						const FVector2D Current = Active[Index];
+						bool bFound = false;
+
+						for (int32 i = 0; i < 20; i++)
+						{
+							const double Angle = Random.FRandRange(0.0, UE_DOUBLE_TWO_PI);
+							const double Dist  = Random.FRandRange(1.0, 2.0);
+
+							FVector2D Candidate = Current + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Dist;
+							Candidate.X = FMath::Fmod(Candidate.X + TileSize, TileSize);
+							Candidate.Y = FMath::Fmod(Candidate.Y + TileSize, TileSize);
+
+							if (TryAdd(Candidate, Margin))
+							{
+								bFound = true;
+								break;
+							}
+						}
+
+						if (!bFound)
+						{
+							Active.RemoveAtSwap(Index);
+						}
+					}
+				}
+			}
+		}
+
+		FORCEINLINE int32 Wrap(int32 Cell) const
+		{
+			return (Cell + Width) % Width;
+		}
+
+		double TileSize = 0.0;
+		double CellSize = 0.0;
+		int32 Width = 0;
+		TArray<int32> Cells;
+		TArray<FVector2D> Points;
+		TArray<FVector2D> Active;
+	};
+}
+
+void UBlueNoiseTileSet::Build()
+{
+	BuildTiles(NumTiles, TileSize, GeneratorSeed, Tiles);
+	MarkPackageDirty();
+}
+
+void UBlueNoiseTileSet::BuildTiles(int32 InNumTiles, float InTileSize, int32 InSeed, TArray<FBlueNoiseTile>& OutTiles)
+{
+	using namespace BlueNoiseTileSet;
+
+	OutTiles.Reset();
+	if (InNumTiles < 1 || InTileSize < 4.0f)
+	{
+		return;
+	}
+
+	FRandomStream Random(InSeed);
+
+	FToroidalSampler Base(InTileSize);
+	Base.Fill(0.0, Random);
+
+	TArray<FVector2D> Band;
+	for (const FVector2D& Point : Base.Points)
+	{
+		if (FMath::Min(FMath::Min(Point.X, Point.Y), FMath::Min(InTileSize - Point.X, InTileSize - Point.Y)) < 1.0)
+		{
+			Band.Add(Point);
+		}
+	}
+
+	OutTiles.SetNum(InNumTiles);
+
+	for (int32 TileIndex = 0; TileIndex < InNumTiles; TileIndex++)
+	{
+		TArray<FVector2D> TilePoints;
+
+		if (TileIndex == 0)
+		{
+			TilePoints = Base.Points;
+		}
+		else
+		{
+			// Interior points stay one spacing away from the edges, so they never see another tile
+			FToroidalSampler Tile(InTileSize);
+			for (const FVector2D& Point : Band)
+			{
+				Tile.TryAdd(Point, 0.0);
+			}
+
+			FRandomStream TileRandom(static_cast<int32>(HashCombine(GetTypeHash(InSeed), GetTypeHash(TileIndex))));
+			Tile.Fill(1.0, TileRandom);
+			TilePoints = MoveTemp(Tile.Points);
+		}
+
+		OutTiles[TileIndex].Points.Reserve(TilePoints.Num());
+		for (const FVector2D& Point : TilePoints)
+		{
+			OutTiles[TileIndex].Points.Add(FVector2f(Point));
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UBlueNoiseTileSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Build();
+}
+#endif
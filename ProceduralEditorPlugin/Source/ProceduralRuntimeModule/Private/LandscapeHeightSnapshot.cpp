@@ -0,0 +1,156 @@
+#include "LandscapeHeightSnapshot.h"
+#include "Landscape.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+namespace LandscapeHeightSnapshot
+{
+	// Past this many samples the grid gets coarser than the landscape resolution
+	constexpr int64 MaxSamples = 4096 * 4096;
+}
+
+void FLandscapeHeightSnapshot::Reset()
+{
+	Origin = FVector2D::ZeroVector;
+	CellSize = 0.0;
+	Width = 0;
+	Height = 0;
+	Heights.Reset();
+}
+
+bool FLandscapeHeightSnapshot::Build(UWorld* World, const FBox2D& Bounds)
+{
+	Reset();
+
+	if (!World || !Bounds.bIsValid)
+	{
+		return false;
+	}
+
+	TArray<ALandscapeProxy*> Proxies;
+	TArray<FBox2D> ProxyBounds;
+	double QuadSize = TNumericLimits<double>::Max();
+
+	for (TActorIterator<ALandscapeProxy> It(World); It; ++It)
+	{
+		const FBox Box = It->GetComponentsBoundingBox();
+		const FBox2D Box2D(FVector2D(Box.Min), FVector2D(Box.Max));
+
+		if (Box.IsValid && Bounds.Intersect(Box2D))
+		{
+			Proxies.Add(*It);
+			ProxyBounds.Add(Box2D);
+			QuadSize = FMath::Min(QuadSize, It->GetActorScale3D().X);
+		}
+	}
+
+	if (Proxies.Num() == 0 || QuadSize <= 0.0)
+	{
+		return false;
+	}
+
+	// One extra cell around the zone so bilinear lookups at the border have their corners
+	const FVector2D Size = Bounds.GetSize() + FVector2D(2.0 * QuadSize);
+	CellSize = QuadSize;
+	while (int64(FMath::CeilToInt(Size.X / CellSize) + 1) * int64(FMath::CeilToInt(Size.Y / CellSize) + 1) > LandscapeHeightSnapshot::MaxSamples)
+	{
+		CellSize *= 2.0;
+	}
+
+	Origin = Bounds.Min - FVector2D(QuadSize);
+	Width  = FMath::CeilToInt(Size.X / CellSize) + 1;
+	Height = FMath::CeilToInt(Size.Y / CellSize) + 1;
+
+	Heights.SetNumUninitialized(Width * Height);
+
+	ParallelFor(Height, [&](int32 Y)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			const FVector2D Location = Origin + FVector2D(X, Y) * CellSize;
+			float& Sample = Heights[Y * Width + X];
+			Sample = NAN;
+
+			for (int32 ProxyIndex = 0; ProxyIndex < Proxies.Num(); ProxyIndex++)
+			{
+				if (!ProxyBounds[ProxyIndex].IsInside(Location))
+				{
+					continue;
+				}
+
+				const TOptional<float> LandscapeHeight = Proxies[ProxyIndex]->GetHeightAtLocation(FVector(Location, 0.0));
+				if (LandscapeHeight.IsSet())
+				{
+					Sample = LandscapeHeight.GetValue();
+					break;
+				}
+			}
+		}
+	});
+
+	return true;
+}
+
+bool FLandscapeHeightSnapshot::GetCorners(const FVector2D& Point, float OutCorners[4], double& OutAlphaX, double& OutAlphaY) const
+{
+	if (Heights.Num() == 0)
+	{
+		return false;
+	}
+
+	const FVector2D Local = (Point - Origin) / CellSize;
+	const int32 X = FMath::FloorToInt32(Local.X);
+	const int32 Y = FMath::FloorToInt32(Local.Y);
+
+	if (X < 0 || Y < 0 || X + 1 >= Width || Y + 1 >= Height)
+	{
+		return false;
+	}
+
+	const float* Row = Heights.GetData() + Y * Width + X;
+	OutCorners[0] = Row[0];
+	OutCorners[1] = Row[1];
+	OutCorners[2] = Row[Width];
+	OutCorners[3] = Row[Width + 1];
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		if (FMath::IsNaN(OutCorners[i]))
+		{
+			return false;
+		}
+	}
+
+	OutAlphaX = Local.X - X;
+	OutAlphaY = Local.Y - Y;
+	return true;
+}
+
+bool FLandscapeHeightSnapshot::SampleHeight(const FVector2D& Point, double& OutZ) const
+{
+	float Corners[4];
+	double AlphaX, AlphaY;
+	if (!GetCorners(Point, Corners, AlphaX, AlphaY))
+	{
+		return false;
+	}
+
+	OutZ = FMath::BiLerp<double>(Corners[0], Corners[1], Corners[2], Corners[3], AlphaX, AlphaY);
+	return true;
+}
+
+bool FLandscapeHeightSnapshot::SampleNormal(const FVector2D& Point, FVector& OutNormal) const
+{
+	float Corners[4];
+	double AlphaX, AlphaY;
+	if (!GetCorners(Point, Corners, AlphaX, AlphaY))
+	{
+		return false;
+	}
+
+	const double SlopeX = FMath::Lerp(Corners[1] - Corners[0], Corners[3] - Corners[2], AlphaY) / CellSize;
+	const double SlopeY = FMath::Lerp(Corners[2] - Corners[0], Corners[3] - Corners[1], AlphaX) / CellSize;
+
+	OutNormal = FVector(-SlopeX, -SlopeY, 1.0).GetSafeNormal();
+	return true;
+}
@@ -0,0 +1,205 @@
+#include "PlacementExclusionIndex.h"
+
+namespace PlacementExclusionIndex
+{
+	// Holes are much smaller than zones, a coarse mask is enough to skip most exact tests
+	constexpr int32 HoleMaskResolution = 64;
+
+	// Buckets along the longest side of the zone, at most
+	constexpr int32 MaxBuckets = 256;
+}
+
+void FPlacementExclusionIndex::Reset()
+{
+	Holes.Reset();
+	Vertices.Reset();
+	Polygons.Reset();
+	GridBounds = FBox2D(ForceInit);
+	CellSize = 0.0;
+	Width = 0;
+	Height = 0;
+	CellStart.Reset();
+	CellHoles.Reset();
+}
+
+void FPlacementExclusionIndex::Build(const FBox2D& Bounds, TConstArrayView<TArray<FVector>> InPolygons, TConstArrayView<FBox2D> Boxes)
+{
+	Reset();
+
+	if (!Bounds.bIsValid)
+	{
+		return;
+	}
+
+	for (const TArray<FVector>& Polygon : InPolygons)
+	{
+		if (Polygon.Num() < 3)
+		{
+			continue;
+		}
+
+		FBox2D HoleBounds(ForceInit);
+		for (const FVector& Point : Polygon)
+		{
+			HoleBounds += FVector2D(Point);
+		}
+
+		if (!Bounds.Intersect(HoleBounds))
+		{
+			continue;
+		}
+
+		FSplinePolygonIndex Index;
+		Index.Build(Polygon, PlacementExclusionIndex::HoleMaskResolution);
+		if (Index.IsEmpty())
+		{
+			continue;
+		}
+
+		FHole& Hole = Holes.AddDefaulted_GetRef();
+		Hole.Bounds = HoleBounds;
+		Hole.FirstVertex = Vertices.Num();
+		Hole.NumVertices = Polygon.Num();
+		Hole.Polygon = Polygons.Add(MoveTemp(Index));
+
+		for (const FVector& Point : Polygon)
+		{
+			Vertices.Add(FVector2D(Point));
+		}
+	}
+
+	for (const FBox2D& Box : Boxes)
+	{
+		if (!Box.bIsValid || !Bounds.Intersect(Box))
+		{
+			continue;
+		}
+
+		FHole& Hole = Holes.AddDefaulted_GetRef();
+		Hole.Bounds = Box;
+		Hole.FirstVertex = Vertices.Num();
+		Hole.NumVertices = 4;
+
+		Vertices.Add(Box.Min);
+		Vertices.Add(FVector2D(Box.Max.X, Box.Min.Y));
+		Vertices.Add(Box.Max);
+		Vertices.Add(FVector2D(Box.Min.X, Box.Max.Y));
+	}
+
+	if (Holes.Num() == 0)
+	{
+		return;
+	}
+
+	double MeanExtent = 0.0;
+	for (FHole& Hole : Holes)
+	{
+		Hole.Hash = FCrc::MemCrc32(Vertices.GetData() + Hole.FirstVertex, Hole.NumVertices * sizeof(FVector2D));
+		MeanExtent += Hole.Bounds.GetSize().GetMax();
+	}
+	MeanExtent /= Holes.Num();
+
+	// Buckets about the size of an average hole, so a hole spans few buckets and a bucket holds few holes
+	const FVector2D Size = Bounds.GetSize();
+	GridBounds = Bounds;
+	CellSize = FMath::Max3(MeanExtent, Size.GetMax() / PlacementExclusionIndex::MaxBuckets, double(UE_KINDA_SMALL_NUMBER));
+	Width  = FMath::Max(1, FMath::CeilToInt32(Size.X / CellSize));
+	Height = FMath::Max(1, FMath::CeilToInt32(Size.Y / CellSize));
+
+	auto ForEachCell = [this](const FBox2D& Box, auto&& Func)
+	{
+		const int32 MinX = GetCellCoord(Box.Min.X, GridBounds.Min.X, Width);
+		const int32 MaxX = GetCellCoord(Box.Max.X, GridBounds.Min.X, Width);
+		const int32 MinY = GetCellCoord(Box.Min.Y, GridBounds.Min.Y, Height);
+		const int32 MaxY = GetCellCoord(Box.Max.Y, GridBounds.Min.Y, Height);
+
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				Func(Y * Width + X);
+			}
+		}
+	};
+
+	TArray<int32> Counts;
+	Counts.Init(0, Width * Height);
+	for (const FHole& Hole : Holes)
+	{
+		ForEachCell(Hole.Bounds, [&Counts](int32 Cell) { Counts[Cell]++; });
+	}
+
+	CellStart.SetNumUninitialized(Width * Height + 1);
+	CellStart[0] = 0;
+	for (int32 Cell = 0; Cell < Width * Height; Cell++)
+	{
+		CellStart[Cell + 1] = CellStart[Cell] + Counts[Cell];
+		Counts[Cell] = CellStart[Cell];
+	}
+
+	CellHoles.SetNumUninitialized(CellStart.Last());
+	for (int32 HoleIndex = 0; HoleIndex < Holes.Num(); HoleIndex++)
+	{
+		ForEachCell(Holes[HoleIndex].Bounds, [&](int32 Cell) { CellHoles[Counts[Cell]++] = HoleIndex; });
+	}
+}
+
+bool FPlacementExclusionIndex::IsExcluded(const FVector2D& Point) const
+{
+	if (Holes.Num() == 0 || !GridBounds.IsInside(Point))
+	{
+		return false;
+	}
+
+	const int32 Cell = GetCellCoord(Point.Y, GridBounds.Min.Y, Height) * Width + GetCellCoord(Point.X, GridBounds.Min.X, Width);
+
+	for (int32 Index = CellStart[Cell]; Index < CellStart[Cell + 1]; Index++)
+	{
+		const FHole& Hole = Holes[CellHoles[Index]];
+		if (Hole.Bounds.IsInside(Point) && (Hole.Polygon == INDEX_NONE || Polygons[Hole.Polygon].IsInside(Point)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint32 FPlacementExclusionIndex::GetOverlapHash(const FBox2D& Box) const
+{
+	if (Holes.Num() == 0 || !GridBounds.Intersect(Box))
+	{
+		return 0;
+	}
+
+	const int32 MinX = GetCellCoord(Box.Min.X, GridBounds.Min.X, Width);
+	const int32 MaxX = GetCellCoord(Box.Max.X, GridBounds.Min.X, Width);
+	const int32 MinY = GetCellCoord(Box.Min.Y, GridBounds.Min.Y, Height);
+	const int32 MaxY = GetCellCoord(Box.Max.Y, GridBounds.Min.Y, Height);
+
+	TArray<int32, TInlineAllocator<16>> Overlapping;
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const int32 Cell = Y * Width + X;
+			for (int32 Index = CellStart[Cell]; Index < CellStart[Cell + 1]; Index++)
+			{
+				if (Holes[CellHoles[Index]].Bounds.Intersect(Box))
+				{
+					Overlapping.AddUnique(CellHoles[Index]);
+				}
+			}
+		}
+	}
+
+	// Bucket order depends on the grid, hole order does not
+	Overlapping.Sort();
+
+	uint32 Hash = 0;
+	for (const int32 HoleIndex : Overlapping)
+	{
+		Hash = HashCombine(Hash, Holes[HoleIndex].Hash);
+	}
+	return Hash;
+}
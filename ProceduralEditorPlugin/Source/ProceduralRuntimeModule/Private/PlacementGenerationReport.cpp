@@ -0,0 +1,38 @@
+#include "PlacementGenerationReport.h"
+
+void FPlacementGenerationReport::SetSamplingStats(const FPlacementSamplingStats& Stats)
+{
+	NumCandidates = Stats.NumCandidates;
+	NumSpacingRejections = Stats.NumSpacingRejections;
+	NumOutsideRejections = Stats.NumOutsideRejections;
+	NumLayerRejections = Stats.NumLayerRejections;
+	PeakActivePoints = Stats.PeakActivePoints;
+}
+
+FString FPlacementGenerationReport::ToString() const
+{
+	if (bFromPointCache)
+	{
+		return FString::Printf(
+			TEXT("Polygon vertices: %d\n")
+			TEXT("Points: %d loaded from the point cache\n")
+			TEXT("Instances: %d\n")
+			TEXT("Time: spline %.2f ms, cache lookup %.2f ms, submit %.2f ms, total %.2f ms"),
+			NumPolygonVertices, NumSampledPoints, NumInstances,
+			CacheSplineMs, SamplingMs, SubmitMs, TotalMs);
+	}
+
+	const double Acceptance = NumCandidates > 0 ? 100.0 * NumSampledPoints / NumCandidates : 0.0;
+
+	return FString::Printf(
+		TEXT("Polygon vertices: %d\n")
+		TEXT("Sampling: %d points from %lld candidates (%.1f%% accepted), %lld too close, %lld outside, %lld blocked by layers, peak active %d\n")
+		TEXT("Projection: %d trace hits, %d misses, %d from heightfield, %d too steep\n")
+		TEXT("Instances: %d\n")
+		TEXT("Time: spline %.2f ms, sampling %.2f ms, projection %.2f ms, submit %.2f ms, total %.2f ms"),
+		NumPolygonVertices,
+		NumSampledPoints, NumCandidates, Acceptance, NumSpacingRejections, NumOutsideRejections, NumLayerRejections, PeakActivePoints,
+		NumTraceHits, NumTraceMisses, NumHeightfieldHits, NumSlopeRejections,
+		NumInstances,
+		CacheSplineMs, SamplingMs, ProjectionMs, SubmitMs, TotalMs);
+}
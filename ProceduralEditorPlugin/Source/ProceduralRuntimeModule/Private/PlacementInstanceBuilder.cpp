@@ -0,0 +1,98 @@
+#include "PlacementInstanceBuilder.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FPlacementInstanceBuilder::FPlacementInstanceBuilder(UInstancedStaticMeshComponent* InComponent, TArray<FTransform>&& InTransforms, float InBudgetMs, int32 InChunkSize)
+	: BudgetMs(InBudgetMs)
+	, ChunkSize(FMath::Max(1, InChunkSize))
+{
+	FTarget& Target = Targets.AddDefaulted_GetRef();
+	Target.Component = InComponent;
+	Target.Transforms = MoveTemp(InTransforms);
+	NumTotal = Target.Transforms.Num();
+}
+
+FPlacementInstanceBuilder::FPlacementInstanceBuilder(TConstArrayView<UInstancedStaticMeshComponent*> InComponents, TArray<TArray<FTransform>>&& InTransforms, float InBudgetMs, int32 InChunkSize)
+	: BudgetMs(InBudgetMs)
+	, ChunkSize(FMath::Max(1, InChunkSize))
+{
+	check(InComponents.Num() == InTransforms.Num());
+
+	for (int32 Index = 0; Index < InComponents.Num(); Index++)
+	{
+		FTarget& Target = Targets.AddDefaulted_GetRef();
+		Target.Component = InComponents[Index];
+		Target.Transforms = MoveTemp(InTransforms[Index]);
+		NumTotal += Target.Transforms.Num();
+	}
+}
+
+FPlacementInstanceBuilder::~FPlacementInstanceBuilder()
+{
+	Cancel();
+}
+
+void FPlacementInstanceBuilder::Start()
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FPlacementInstanceBuilder::Tick));
+}
+
+void FPlacementInstanceBuilder::Cancel()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+bool FPlacementInstanceBuilder::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FPlacementInstanceBuilder::Tick);
+
+	// At least one chunk per tick, so a tiny budget still makes progress
+	const double Deadline = FPlatformTime::Seconds() + BudgetMs / 1000.0;
+	while (!IsDone())
+	{
+		FTarget& Target = Targets[CurrentTarget];
+		if (Target.NumAdded == Target.Transforms.Num())
+		{
+			CurrentTarget++;
+			continue;
+		}
+
+		UInstancedStaticMeshComponent* ISM = Target.Component.Get();
+		if (!ISM)
+		{
+			TickerHandle.Reset();
+			return false;
+		}
+
+		const int32 Count = FMath::Min(ChunkSize, Target.Transforms.Num() - Target.NumAdded);
+		const TArray<FTransform> Chunk(Target.Transforms.GetData() + Target.NumAdded, Count);
+		ISM->AddInstances(Chunk, false, true);
+		Target.NumAdded += Count;
+		NumAdded += Count;
+
+		if (FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+	}
+
+	if (!IsDone())
+	{
+		return true;
+	}
+
+	TickerHandle.Reset();
+	Targets.Empty();
+	CurrentTarget = 0;
+	NumAdded = 0;
+	NumTotal = 0;
+
+	// Keep this alive while the owner drops its reference from the callback
+	TSharedRef<FPlacementInstanceBuilder> KeepAlive = AsShared();
+	OnBuilt.ExecuteIfBound();
+	return false;
+}
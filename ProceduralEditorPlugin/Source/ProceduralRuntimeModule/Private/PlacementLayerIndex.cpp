@@ -0,0 +1,92 @@
+#include "PlacementLayerIndex.h"
+
+void FPlacementLayerIndex::Init(const FBox2D& InBounds, float InMaxRadius)
+{
+	Reset();
+
+	if (!InBounds.bIsValid)
+	{
+		return;
+	}
+
+	// Points up to two radii outside the zone still block candidates along its border
+	MaxRadius = FMath::Max(InMaxRadius, UE_KINDA_SMALL_NUMBER);
+	Bounds = InBounds.ExpandBy(2.0 * MaxRadius);
+	CellSize = 2.0 * MaxRadius;
+
+	const FVector2D Size = Bounds.GetSize();
+	Width  = FMath::Max(1, FMath::CeilToInt32(Size.X / CellSize));
+	Height = FMath::Max(1, FMath::CeilToInt32(Size.Y / CellSize));
+	Heads.Init(INDEX_NONE, Width * Height);
+}
+
+void FPlacementLayerIndex::Reset()
+{
+	Bounds = FBox2D(ForceInit);
+	CellSize = 0.0;
+	MaxRadius = 0.0f;
+	Width = 0;
+	Height = 0;
+	Heads.Reset();
+	Next.Reset();
+	Points.Reset();
+	Radii.Reset();
+}
+
+void FPlacementLayerIndex::Add(TConstArrayView<FVector> InPoints, float Radius)
+{
+	if (Heads.Num() == 0)
+	{
+		return;
+	}
+
+	Radius = FMath::Min(Radius, MaxRadius);
+
+	for (const FVector& Point : InPoints)
+	{
+		const FVector2D PointXY(Point);
+		if (!Bounds.IsInside(PointXY))
+		{
+			continue;
+		}
+
+		const int32 X = GetCellCoord(PointXY.X, Bounds.Min.X, Width);
+		const int32 Y = GetCellCoord(PointXY.Y, Bounds.Min.Y, Height);
+		int32& Head = Heads[Y * Width + X];
+
+		Next.Add(Head);
+		Head = Points.Add(PointXY);
+		Radii.Add(Radius);
+	}
+}
+
+bool FPlacementLayerIndex::IsBlocked(const FVector2D& Candidate, float Radius) const
+{
+	if (Points.Num() == 0)
+	{
+		return false;
+	}
+
+	const double Reach = double(Radius) + MaxRadius;
+	const int32 MinX = GetCellCoord(Candidate.X - Reach, Bounds.Min.X, Width);
+	const int32 MaxX = GetCellCoord(Candidate.X + Reach, Bounds.Min.X, Width);
+	const int32 MinY = GetCellCoord(Candidate.Y - Reach, Bounds.Min.Y, Height);
+	const int32 MaxY = GetCellCoord(Candidate.Y + Reach, Bounds.Min.Y, Height);
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			for (int32 Index = Heads[Y * Width + X]; Index != INDEX_NONE; Index = Next[Index])
+			{
+				const double Clearance = double(Radius) + Radii[Index];
+				if (FVector2D::DistSquared(Points[Index], Candidate) < Clearance * Clearance)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,98 @@
+#include "PlacementPointCache.h"
+#include "ProceduralRuntimeModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace PlacementPointCache
+{
+	constexpr uint32 Magic = 0x50504331; // PPC1
+	constexpr uint32 Version = 1;
+
+	FString GetFilename(const FString& Key)
+	{
+		return FPaths::Combine(FPlacementPointCache::GetDirectory(), Key + TEXT(".bin"));
+	}
+}
+
+FString FPlacementPointCache::GetDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ProceduralPlacementCache"));
+}
+
+bool FPlacementPointCache::Load(const FString& Key, TArray<FVector>& OutPoints)
+{
+	TArray<uint8> File;
+	if (!FFileHelper::LoadFileToArray(File, *PlacementPointCache::GetFilename(Key), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(File);
+
+	uint32 Magic = 0, Version = 0;
+	int32 NumPoints = 0, UncompressedSize = 0;
+	Reader << Magic << Version << NumPoints << UncompressedSize;
+
+	if (Reader.IsError() || Magic != PlacementPointCache::Magic || Version != PlacementPointCache::Version
+		|| NumPoints < 0 || UncompressedSize != NumPoints * int32(sizeof(FVector)))
+	{
+		UE_LOG(LogProceduralPlacement, Warning, TEXT("Ignoring invalid point cache file %s"), *Key);
+		return false;
+	}
+
+	const int64 Offset = Reader.Tell();
+	OutPoints.SetNumUninitialized(NumPoints);
+
+	if (!FCompression::UncompressMemory(NAME_Oodle, OutPoints.GetData(), UncompressedSize, File.GetData() + Offset, int32(File.Num() - Offset)))
+	{
+		UE_LOG(LogProceduralPlacement, Warning, TEXT("Could not decompress point cache file %s"), *Key);
+		OutPoints.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FPlacementPointCache::Save(const FString& Key, TConstArrayView<FVector> Points)
+{
+	int32 UncompressedSize = Points.Num() * int32(sizeof(FVector));
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, UncompressedSize);
+
+	TArray<uint8> File;
+	FMemoryWriter Writer(File);
+
+	uint32 Magic = PlacementPointCache::Magic;
+	uint32 Version = PlacementPointCache::Version;
+	int32 NumPoints = Points.Num();
+	Writer << Magic << Version << NumPoints << UncompressedSize;
+
+	const int64 Offset = File.Num();
+	File.AddUninitialized(CompressedSize);
+
+	if (!FCompression::CompressMemory(NAME_Oodle, File.GetData() + Offset, CompressedSize, Points.GetData(), UncompressedSize))
+	{
+		return false;
+	}
+	File.SetNum(int32(Offset) + CompressedSize);
+
+	// Written next to the final file and moved, so a reader never sees a partial file
+	const FString Filename = PlacementPointCache::GetFilename(Key);
+	const FString TempFilename = FPaths::CreateTempFilename(*GetDirectory(), *Key, TEXT(".tmp"));
+
+	if (!FFileHelper::SaveArrayToFile(File, *TempFilename))
+	{
+		UE_LOG(LogProceduralPlacement, Warning, TEXT("Could not write point cache file %s"), *TempFilename);
+		return false;
+	}
+
+	return IFileManager::Get().Move(*Filename, *TempFilename, true, true, false, true);
+}
+
+void FPlacementPointCache::Clear()
+{
+	IFileManager::Get().DeleteDirectory(*GetDirectory(), false, true);
+}
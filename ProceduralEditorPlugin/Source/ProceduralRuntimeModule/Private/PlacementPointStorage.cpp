@@ -0,0 +1,333 @@
+#include "PlacementPointStorage.h"
+#include "ProceduralRuntimeModule.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Compression.h"
+#include <atomic>
+
+namespace PlacementPointStorage
+{
+	// 2: chunks can keep full precision XY
+	// 3: wide chunks are cell coded instead
+	constexpr int32 Version = 3;
+
+	// Finest height step, for zones with a very small spacing
+	constexpr double MinHeightStep = 0.01;
+
+	// Coarsest XY step of a quantized chunk, as a fraction of Spacing
+	constexpr double MaxStepPerSpacing = 1.0 / 64.0;
+
+	FORCEINLINE void WriteVarInt(TArray<uint8>& Out, int64 Value)
+	{
+		// Zigzag so small negative deltas stay small
+		uint64 Bits = (uint64(Value) << 1) ^ uint64(Value >> 63);
+		while (Bits >= 0x80)
+		{
+			Out.Add(uint8(Bits | 0x80));
+			Bits >>= 7;
+		}
+		Out.Add(uint8(Bits));
+	}
+
+	FORCEINLINE bool ReadVarInt(const uint8*& Cursor, const uint8* End, int64& OutValue)
+	{
+		uint64 Bits = 0;
+		for (int32 Shift = 0; Shift < 64; Shift += 7)
+		{
+			if (Cursor == End)
+			{
+				return false;
+			}
+
+			const uint8 Byte = *Cursor++;
+			Bits |= uint64(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80))
+			{
+				OutValue = int64(Bits >> 1) ^ -int64(Bits & 1);
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void FPlacementPointStorage::SerializeChunk(FArchive& Ar, FChunk& Chunk, int32 Version)
+{
+	Ar << Chunk.Min << Chunk.Step << Chunk.NumPoints << Chunk.RawSize;
+	if (Version >= 2)
+	{
+		Ar << Chunk.bFullPrecision;
+	}
+	if (Version >= 3)
+	{
+		Ar << Chunk.bCellCoded;
+	}
+	Chunk.Data.BulkSerialize(Ar);
+}
+
+void FPlacementPointStorage::Reset()
+{
+	NumPoints = 0;
+	HeightStep = 1.0;
+	Chunks.Empty();
+}
+
+SIZE_T FPlacementPointStorage::GetAllocatedSize() const
+{
+	SIZE_T Size = Chunks.GetAllocatedSize();
+	for (const FChunk& Chunk : Chunks)
+	{
+		Size += Chunk.Data.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FPlacementPointStorage::Encode(TConstArrayView<FVector> Points, float Spacing, bool bCompress)
+{
+	Reset();
+
+	NumPoints = Points.Num();
+	HeightStep = FMath::Max(double(Spacing) / 1024.0, PlacementPointStorage::MinHeightStep);
+	Chunks.SetNum(FMath::DivideAndRoundUp(NumPoints, ChunkSize));
+
+	const double MaxStep = double(Spacing) * PlacementPointStorage::MaxStepPerSpacing;
+
+	ParallelFor(Chunks.Num(), [this, Points, MaxStep, bCompress](int32 ChunkIndex)
+	{
+		const int32 First = ChunkIndex * ChunkSize;
+		EncodeChunk(Points.Slice(First, FMath::Min(ChunkSize, NumPoints - First)), HeightStep, MaxStep, bCompress, Chunks[ChunkIndex]);
+	});
+}
+
+void FPlacementPointStorage::EncodeChunk(TConstArrayView<FVector> Points, double HeightStep, double MaxStep, bool bCompress, FChunk& OutChunk)
+{
+	const int32 N = Points.Num();
+	const FBox Bounds(Points);
+
+	OutChunk.Min = Bounds.Min;
+	OutChunk.Step = FVector2D(
+		FMath::Max(Bounds.Max.X - Bounds.Min.X, UE_DOUBLE_SMALL_NUMBER) / MAX_uint16,
+		FMath::Max(Bounds.Max.Y - Bounds.Min.Y, UE_DOUBLE_SMALL_NUMBER) / MAX_uint16);
+	OutChunk.NumPoints = N;
+	OutChunk.bFullPrecision = false;
+
+	// Consecutive points can spread over the whole zone, e.g. progressive zones. 16 bits
+	// over such a chunk would be too coarse for the spacing, so each point keeps 16 bits
+	// within a cell of 65536 steps and the cells are delta coded.
+	OutChunk.bCellCoded = OutChunk.Step.GetMax() > MaxStep;
+	if (OutChunk.bCellCoded)
+	{
+		OutChunk.Step = FVector2D(FMath::Max(MaxStep, UE_DOUBLE_SMALL_NUMBER));
+	}
+
+	// X block, Y block, then the varints: cell deltas if any and height delta, per point
+	TArray<uint8> Raw;
+	Raw.SetNumUninitialized(N * 2 * sizeof(uint16));
+
+	TArray<uint8> Deltas;
+	Deltas.Reserve(OutChunk.bCellCoded ? N * 4 : N * 2);
+
+	uint16* X = reinterpret_cast<uint16*>(Raw.GetData());
+	uint16* Y = X + N;
+
+	int64 PreviousHeight = 0;
+	FInt64Point PreviousCell(0, 0);
+	for (int32 i = 0; i < N; i++)
+	{
+		const FVector& Point = Points[i];
+		if (OutChunk.bCellCoded)
+		{
+			const int64 QX = FMath::RoundToInt64((Point.X - Bounds.Min.X) / OutChunk.Step.X);
+			const int64 QY = FMath::RoundToInt64((Point.Y - Bounds.Min.Y) / OutChunk.Step.Y);
+			X[i] = uint16(QX & MAX_uint16);
+			Y[i] = uint16(QY & MAX_uint16);
+
+			const FInt64Point Cell(QX >> 16, QY >> 16);
+			PlacementPointStorage::WriteVarInt(Deltas, Cell.X - PreviousCell.X);
+			PlacementPointStorage::WriteVarInt(Deltas, Cell.Y - PreviousCell.Y);
+			PreviousCell = Cell;
+		}
+		else
+		{
+			X[i] = uint16(FMath::Clamp<int64>(FMath::RoundToInt64((Point.X - Bounds.Min.X) / OutChunk.Step.X), 0, MAX_uint16));
+			Y[i] = uint16(FMath::Clamp<int64>(FMath::RoundToInt64((Point.Y - Bounds.Min.Y) / OutChunk.Step.Y), 0, MAX_uint16));
+		}
+
+		const int64 Height = FMath::RoundToInt64((Point.Z - Bounds.Min.Z) / HeightStep);
+		PlacementPointStorage::WriteVarInt(Deltas, Height - PreviousHeight);
+		PreviousHeight = Height;
+	}
+
+	Raw.Append(Deltas);
+
+	OutChunk.RawSize = 0;
+	OutChunk.Data.Reset();
+
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Raw.Num());
+		OutChunk.Data.SetNumUninitialized(CompressedSize);
+
+		// Kept raw when Oodle does not win anything
+		if (FCompression::CompressMemory(NAME_Oodle, OutChunk.Data.GetData(), CompressedSize, Raw.GetData(), Raw.Num()) && CompressedSize < Raw.Num())
+		{
+			OutChunk.Data.SetNum(CompressedSize);
+			OutChunk.RawSize = Raw.Num();
+			return;
+		}
+	}
+
+	OutChunk.Data = MoveTemp(Raw);
+}
+
+void FPlacementPointStorage::Decode(TArray<FVector>& OutPoints) const
+{
+	OutPoints.SetNumUninitialized(NumPoints);
+
+	std::atomic<bool> bFailed { false };
+
+	ParallelFor(Chunks.Num(), [this, &OutPoints, &bFailed](int32 ChunkIndex)
+	{
+		if (!DecodeChunk(Chunks[ChunkIndex], HeightStep, OutPoints.GetData() + ChunkIndex * ChunkSize))
+		{
+			bFailed = true;
+		}
+	});
+
+	if (bFailed)
+	{
+		UE_LOG(LogProceduralPlacement, Error, TEXT("Corrupted placement point storage, %d points dropped"), NumPoints);
+		OutPoints.Reset();
+	}
+}
+
+bool FPlacementPointStorage::DecodeChunk(const FChunk& Chunk, double HeightStep, FVector* OutPoints)
+{
+	const int32 N = Chunk.NumPoints;
+
+	TArray<uint8> Uncompressed;
+	const TArray<uint8>* Raw = &Chunk.Data;
+
+	if (Chunk.RawSize > 0)
+	{
+		Uncompressed.SetNumUninitialized(Chunk.RawSize);
+		if (!FCompression::UncompressMemory(NAME_Oodle, Uncompressed.GetData(), Chunk.RawSize, Chunk.Data.GetData(), Chunk.Data.Num()))
+		{
+			return false;
+		}
+		Raw = &Uncompressed;
+	}
+
+	const int32 CoordSize = Chunk.bFullPrecision ? sizeof(double) : sizeof(uint16);
+	if (Raw->Num() < N * 2 * CoordSize)
+	{
+		return false;
+	}
+
+	const uint16* X = reinterpret_cast<const uint16*>(Raw->GetData());
+	const uint16* Y = X + N;
+	const double* FullX = reinterpret_cast<const double*>(Raw->GetData());
+	const double* FullY = FullX + N;
+	const uint8* Cursor = Raw->GetData() + N * 2 * CoordSize;
+	const uint8* End = Raw->GetData() + Raw->Num();
+
+	int64 Height = 0;
+	FInt64Point Cell(0, 0);
+	for (int32 i = 0; i < N; i++)
+	{
+		if (Chunk.bCellCoded)
+		{
+			int64 CellX, CellY;
+			if (!PlacementPointStorage::ReadVarInt(Cursor, End, CellX) || !PlacementPointStorage::ReadVarInt(Cursor, End, CellY))
+			{
+				return false;
+			}
+			Cell += FInt64Point(CellX, CellY);
+		}
+
+		int64 Delta;
+		if (!PlacementPointStorage::ReadVarInt(Cursor, End, Delta))
+		{
+			return false;
+		}
+		Height += Delta;
+
+		if (Chunk.bCellCoded)
+		{
+			OutPoints[i] = FVector(
+				Chunk.Min.X + ((Cell.X << 16) | X[i]) * Chunk.Step.X,
+				Chunk.Min.Y + ((Cell.Y << 16) | Y[i]) * Chunk.Step.Y,
+				Chunk.Min.Z + Height * HeightStep);
+		}
+		else if (Chunk.bFullPrecision)
+		{
+			OutPoints[i] = FVector(FullX[i], FullY[i], Chunk.Min.Z + Height * HeightStep);
+		}
+		else
+		{
+			OutPoints[i] = FVector(
+				Chunk.Min.X + X[i] * Chunk.Step.X,
+				Chunk.Min.Y + Y[i] * Chunk.Step.Y,
+				Chunk.Min.Z + Height * HeightStep);
+		}
+	}
+
+	return true;
+}
+
+bool FPlacementPointStorage::Serialize(FArchive& Ar)
+{
+	int32 Version = PlacementPointStorage::Version;
+	Ar << Version << NumPoints << HeightStep;
+
+	// Version 1 chunks are read as quantized ones, version 2 ones are never cell coded
+	if (Ar.IsLoading() && (Version < 1 || Version > PlacementPointStorage::Version))
+	{
+		Ar.SetError();
+		Reset();
+		return true;
+	}
+
+	int32 NumChunks = Chunks.Num();
+	Ar << NumChunks;
+
+	if (Ar.IsLoading())
+	{
+		// Chunk sizes are unknown past a bad count, the rest of the archive cannot be read
+		if (NumPoints < 0 || NumChunks != FMath::DivideAndRoundUp(NumPoints, ChunkSize))
+		{
+			UE_LOG(LogProceduralPlacement, Error, TEXT("Corrupted placement point storage, %d points dropped"), NumPoints);
+			Ar.SetError();
+			Reset();
+			return true;
+		}
+		Chunks.SetNum(NumChunks);
+	}
+
+	for (FChunk& Chunk : Chunks)
+	{
+		SerializeChunk(Ar, Chunk, Version);
+	}
+
+	if (Ar.IsLoading())
+	{
+		// Decode writes chunk i at i * ChunkSize, so every chunk but the last must be full
+		bool bValid = NumPoints >= 0 && Chunks.Num() == FMath::DivideAndRoundUp(NumPoints, ChunkSize);
+		for (int32 ChunkIndex = 0; bValid && ChunkIndex < Chunks.Num(); ChunkIndex++)
+		{
+			bValid = Chunks[ChunkIndex].NumPoints == FMath::Min(ChunkSize, NumPoints - ChunkIndex * ChunkSize);
+		}
+
+		if (!bValid)
+		{
+			UE_LOG(LogProceduralPlacement, Error, TEXT("Corrupted placement point storage, %d points dropped"), NumPoints);
+			Reset();
+		}
+	}
+
+	return true;
+}
+
+bool FPlacementPointStorage::Identical(const FPlacementPointStorage* Other, uint32 PortFlags) const
+{
+	return Other && NumPoints == 0 && Other->NumPoints == 0;
+}
@@ -0,0 +1,52 @@
+#include "PlacementSpacingMap.h"
+
+void FPlacementSpacingMap::Init(const FBox2D& Bounds, double InCellSize)
+{
+	Origin = Bounds.Min;
+	CellSize = InCellSize;
+	Width  = FMath::Max(1, FMath::CeilToInt32(Bounds.GetSize().X / CellSize));
+	Height = FMath::Max(1, FMath::CeilToInt32(Bounds.GetSize().Y / CellSize));
+	Spacings.SetNumZeroed(Width * Height);
+	MinSpacing = 0.0f;
+	MaxSpacing = 0.0f;
+}
+
+void FPlacementSpacingMap::Reset()
+{
+	Origin = FVector2D::ZeroVector;
+	CellSize = 0.0;
+	Width = 0;
+	Height = 0;
+	Spacings.Reset();
+	MinSpacing = 0.0f;
+	MaxSpacing = 0.0f;
+}
+
+float FPlacementSpacingMap::GetSpacing(const FVector2D& Point) const
+{
+	const FVector2D Local = (Point - Origin) / CellSize - FVector2D(0.5);
+
+	const int32 X0 = FMath::Clamp(FMath::FloorToInt32(Local.X), 0, Width - 1);
+	const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(Local.Y), 0, Height - 1);
+	const int32 X1 = FMath::Min(X0 + 1, Width - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Height - 1);
+
+	const float AlphaX = FMath::Clamp(float(Local.X - X0), 0.0f, 1.0f);
+	const float AlphaY = FMath::Clamp(float(Local.Y - Y0), 0.0f, 1.0f);
+
+	return FMath::BiLerp(
+		Spacings[Y0 * Width + X0], Spacings[Y0 * Width + X1],
+		Spacings[Y1 * Width + X0], Spacings[Y1 * Width + X1],
+		AlphaX, AlphaY);
+}
+
+void FPlacementSpacingMap::UpdateRange()
+{
+	MinSpacing = TNumericLimits<float>::Max();
+	MaxSpacing = 0.0f;
+	for (const float Spacing : Spacings)
+	{
+		MinSpacing = FMath::Min(MinSpacing, Spacing);
+		MaxSpacing = FMath::Max(MaxSpacing, Spacing);
+	}
+}
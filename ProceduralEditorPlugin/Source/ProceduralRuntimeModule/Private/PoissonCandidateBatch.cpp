@@ -0,0 +1,91 @@
+#include "PoissonCandidateBatch.h"
+#include "PoissonSampleGrid.h"
+
+namespace PoissonCandidateBatch
+{
+	constexpr int32 NumRegisters = FPoissonCandidateBatch::Num / 4;
+
+	// Candidates are at most 2 * Spacing (2.83 cells) from the center and look 2 cells
+	// around themselves, so this many cells around the center cover every neighborhood
+	constexpr int32 GatherRadius = 5;
+
+	static_assert(FPoissonCandidateBatch::Num % 4 == 0, "Candidates are processed four at a time");
+}
+
+void FPoissonCandidateBatch::Generate(const FVector& InCenter, float Spacing, FRandomStream& Random)
+{
+	Center = InCenter;
+
+	// Scalar FMath::Cos/Sin and the same double products as the one-at-a-time loop,
+	// so every candidate lands on exactly the same position for a given seed
+	for (int32 i = 0; i < Num; i++)
+	{
+		const float Angle = Random.FRandRange(0, TWO_PI);
+		const float Dist  = Random.FRandRange(Spacing, Spacing * 2);
+		StreamAfter[i] = Random;
+
+		X[i] = Center.X + double(FMath::Cos(Angle)) * Dist;
+		Y[i] = Center.Y + double(FMath::Sin(Angle)) * Dist;
+	}
+}
+
+// Walks the cells around the center once and tests each grid point against all
+// candidates, instead of one 5x5 walk per candidate.
+
+uint32 FPoissonCandidateBatch::FindCrowded(const FPoissonSampleGrid& Grid, float RadiusSquared) const
+{
+	using namespace PoissonCandidateBatch;
+
+	const int32 CenterX = FMath::FloorToInt((Center.X - Grid.Min.X) / Grid.CellSize);
+	const int32 CenterY = FMath::FloorToInt((Center.Y - Grid.Min.Y) / Grid.CellSize);
+
+	const int32 MinX = FMath::Max(0, CenterX - GatherRadius);
+	const int32 MaxX = FMath::Min(CenterX + GatherRadius, Grid.Width - 1);
+	const int32 MinY = FMath::Max(0, CenterY - GatherRadius);
+	const int32 MaxY = FMath::Min(CenterY + GatherRadius, Grid.Height - 1);
+
+	const VectorRegister4Double Radius = VectorSetFloat1(double(RadiusSquared));
+
+	VectorRegister4Double CandidateX[NumRegisters];
+	VectorRegister4Double CandidateY[NumRegisters];
+	VectorRegister4Double Crowded[NumRegisters];
+	for (int32 r = 0; r < NumRegisters; r++)
+	{
+		CandidateX[r] = VectorLoadAligned(X + r * 4);
+		CandidateY[r] = VectorLoadAligned(Y + r * 4);
+		Crowded[r] = VectorZeroDouble();
+	}
+
+	for (int32 CellY = MinY; CellY <= MaxY; CellY++)
+	{
+		const int32* Row = Grid.Cells.GetData() + CellY * Grid.Width;
+		for (int32 CellX = MinX; CellX <= MaxX; CellX++)
+		{
+			const int32 Idx = Row[CellX];
+			if (Idx == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FVector2D& Point = Grid.Points[Idx];
+			const VectorRegister4Double PointX = VectorSetFloat1(Point.X);
+			const VectorRegister4Double PointY = VectorSetFloat1(Point.Y);
+
+			for (int32 r = 0; r < NumRegisters; r++)
+			{
+				// Multiply then add, like the scalar DistSquared, so borderline points get the same answer
+				const VectorRegister4Double DX = VectorSubtract(CandidateX[r], PointX);
+				const VectorRegister4Double DY = VectorSubtract(CandidateY[r], PointY);
+				const VectorRegister4Double DistSquared = VectorAdd(VectorMultiply(DX, DX), VectorMultiply(DY, DY));
+				Crowded[r] = VectorBitwiseOr(Crowded[r], VectorCompareLT(DistSquared, Radius));
+			}
+		}
+	}
+
+	uint32 Mask = 0;
+	for (int32 r = 0; r < NumRegisters; r++)
+	{
+		Mask |= uint32(VectorMaskBits(Crowded[r])) << (r * 4);
+	}
+	return Mask;
+}
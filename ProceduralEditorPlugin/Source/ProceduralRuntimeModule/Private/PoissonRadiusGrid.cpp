@@ -0,0 +1,78 @@
+#include "PoissonRadiusGrid.h"
+
+void FPoissonRadiusGrid::Init(const FVector2D& InMin, const FVector2D& InMax, float MinRadius, float MaxRadius)
+{
+	Min = InMin;
+	Max = InMax;
+	Points.Reset();
+	Levels.Reset();
+
+	const FVector2D Size = Max - Min;
+	double CellSize = FMath::Max(double(MinRadius), UE_KINDA_SMALL_NUMBER);
+
+	// Coarser levels until one cell covers the largest radius
+	do
+	{
+		FLevel& Level = Levels.AddDefaulted_GetRef();
+		Level.CellSize = CellSize;
+		Level.Width  = FMath::Max(1, FMath::CeilToInt32(Size.X / CellSize));
+		Level.Height = FMath::Max(1, FMath::CeilToInt32(Size.Y / CellSize));
+		Level.Heads.Init(INDEX_NONE, Level.Width * Level.Height);
+
+		CellSize *= 2.0;
+	}
+	while (Levels.Last().CellSize < MaxRadius);
+}
+
+bool FPoissonRadiusGrid::IsInBounds(const FVector2D& Point) const
+{
+	return Point.X >= Min.X && Point.X <= Max.X && Point.Y >= Min.Y && Point.Y <= Max.Y;
+}
+
+bool FPoissonRadiusGrid::HasNeighborWithin(const FVector2D& Candidate, float Radius) const
+{
+	int32 LevelIndex = 0;
+	while (LevelIndex < Levels.Num() - 1 && Levels[LevelIndex].CellSize < Radius)
+	{
+		LevelIndex++;
+	}
+
+	const FLevel& Level = Levels[LevelIndex];
+	const int32 MinX = GetCellCoord(Candidate.X - Radius, Min.X, Level.CellSize, Level.Width);
+	const int32 MaxX = GetCellCoord(Candidate.X + Radius, Min.X, Level.CellSize, Level.Width);
+	const int32 MinY = GetCellCoord(Candidate.Y - Radius, Min.Y, Level.CellSize, Level.Height);
+	const int32 MaxY = GetCellCoord(Candidate.Y + Radius, Min.Y, Level.CellSize, Level.Height);
+
+	const double RadiusSquared = double(Radius) * Radius;
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			for (int32 Index = Level.Heads[Y * Level.Width + X]; Index != INDEX_NONE; Index = Level.Next[Index])
+			{
+				if (FVector2D::DistSquared(Points[Index], Candidate) < RadiusSquared)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void FPoissonRadiusGrid::Add(const FVector2D& Point)
+{
+	const int32 Index = Points.Add(Point);
+
+	for (FLevel& Level : Levels)
+	{
+		const int32 X = GetCellCoord(Point.X, Min.X, Level.CellSize, Level.Width);
+		const int32 Y = GetCellCoord(Point.Y, Min.Y, Level.CellSize, Level.Height);
+		int32& Head = Level.Heads[Y * Level.Width + X];
+
+		Level.Next.Add(Head);
+		Head = Index;
+	}
+}
@@ -0,0 +1,81 @@
+#include "PoissonSampleGrid.h"
+
+void FPoissonSampleGrid::Init(const FVector& InMin, const FVector& InMax, float InCellSize)
+{
+	Min = FVector2D(InMin);
+	Max = FVector2D(InMax);
+	CellSize = InCellSize;
+
+	Width  = FMath::Max(0, FMath::CeilToInt((InMax.X - InMin.X) / CellSize));
+	Height = FMath::Max(0, FMath::CeilToInt((InMax.Y - InMin.Y) / CellSize));
+
+	Cells.Init(INDEX_NONE, Width * Height);
+	Points.Reset();
+}
+
+void FPoissonSampleGrid::InitSlotted(const FVector2D& InMin, float InCellSize, int32 InWidth, int32 InHeight)
+{
+	Min = InMin;
+	CellSize = InCellSize;
+	Width = InWidth;
+	Height = InHeight;
+	Max = Min + FVector2D(Width, Height) * CellSize;
+
+	Cells.Init(INDEX_NONE, Width * Height);
+	Points.SetNumUninitialized(Width * Height);
+}
+
+bool FPoissonSampleGrid::GetCell(const FVector& Point, int32& OutX, int32& OutY) const
+{
+	if (Point.X < Min.X || Point.X > Max.X ||
+		Point.Y < Min.Y || Point.Y > Max.Y)
+	{
+		return false;
+	}
+
+	OutX = FMath::FloorToInt((Point.X - Min.X) / CellSize);
+	OutY = FMath::FloorToInt((Point.Y - Min.Y) / CellSize);
+
+	return OutX >= 0 && OutX < Width && OutY >= 0 && OutY < Height;
+}
+
+int32 FPoissonSampleGrid::Add(const FVector& Point, int32 CellX, int32 CellY)
+{
+	const int32 Index = Points.Add(FVector2D(Point.X, Point.Y));
+	Cells[GetCellIndex(CellX, CellY)] = Index;
+	return Index;
+}
+
+int32 FPoissonSampleGrid::AddToSlot(const FVector& Point, int32 CellX, int32 CellY)
+{
+	const int32 Index = GetCellIndex(CellX, CellY);
+	Points[Index] = FVector2D(Point.X, Point.Y);
+	Cells[Index] = Index;
+	return Index;
+}
+
+bool FPoissonSampleGrid::HasNeighborWithin(const FVector& Candidate, int32 CellX, int32 CellY, float RadiusSquared) const
+{
+	const FVector2D Point(Candidate.X, Candidate.Y);
+
+	const int32 MinX = FMath::Max(0, CellX - 2);
+	const int32 MaxX = FMath::Min(CellX + 2, Width - 1);
+	const int32 MinY = FMath::Max(0, CellY - 2);
+	const int32 MaxY = FMath::Min(CellY + 2, Height - 1);
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		const int32* Row = Cells.GetData() + Y * Width;
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const int32 Idx = Row[X];
+			if (Idx != INDEX_NONE &&
+				FVector2D::DistSquared(Points[Idx], Point) < RadiusSquared)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
@@ -1,278 +1,3525 @@
 #include "ProceduralPlacementComponent.h"
+#include "ProceduralRuntimeModule.h"
+#include "PoissonCandidateBatch.h"
+#include "PoissonRadiusGrid.h"
+#include "PlacementPointCache.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Async/Async.h"
 #include "Async/ParallelFor.h"
 #include "DrawDebugHelpers.h"
+#include "Algo/BinarySearch.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Engine/Texture2D.h"
+#include "Hash/Blake3.h"
+#include "Engine/OverlapResult.h"
+#include "Components/StaticMeshComponent.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("Generate"), STAT_PlacementGenerate, STATGROUP_ProceduralPlacement);
+DECLARE_CYCLE_STAT(TEXT("Cache Spline"), STAT_PlacementCacheSpline, STATGROUP_ProceduralPlacement);
+DECLARE_CYCLE_STAT(TEXT("Poisson Disk"), STAT_PlacementPoissonDisk, STATGROUP_ProceduralPlacement);
+DECLARE_CYCLE_STAT(TEXT("Project Points"), STAT_PlacementProjectPoints, STATGROUP_ProceduralPlacement);
+DECLARE_CYCLE_STAT(TEXT("Submit Instances"), STAT_PlacementSubmitInstances, STATGROUP_ProceduralPlacement);
+DECLARE_CYCLE_STAT(TEXT("Regenerate Changed Tiles"), STAT_PlacementRegenerateTiles, STATGROUP_ProceduralPlacement);
+
+// Values of the last generation, set once it is published
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Candidates"), STAT_PlacementCandidates, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spacing Rejections"), STAT_PlacementSpacingRejections, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Outside Rejections"), STAT_PlacementOutsideRejections, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Layer Rejections"), STAT_PlacementLayerRejections, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Peak Active Points"), STAT_PlacementPeakActivePoints, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Trace Hits"), STAT_PlacementTraceHits, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Trace Misses"), STAT_PlacementTraceMisses, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Heightfield Hits"), STAT_PlacementHeightfieldHits, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Slope Rejections"), STAT_PlacementSlopeRejections, STATGROUP_ProceduralPlacement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instances Submitted"), STAT_PlacementInstances, STATGROUP_ProceduralPlacement);
+
+// Active list of the serial sampler, plotted over time in Insights
+TRACE_DECLARE_INT_COUNTER(PlacementActivePoints, TEXT("ProceduralPlacement/ActivePoints"));
+
+static float GPlacementDensityScale = 1.0f;
+
+static void OnPlacementDensityScaleChanged(IConsoleVariable* Variable)
+{
+	for (TObjectIterator<UProceduralPlacementComponent> It(RF_ClassDefaultObject | RF_ArchetypeObject); It; ++It)
+	{
+		It->ApplyDensityScale();
+	}
+}
+
+static FAutoConsoleVariableRef CVarPlacementDensityScale(
+	TEXT("placement.DensityScale"),
+	GPlacementDensityScale,
+	TEXT("Share of the instances of progressive placement zones that are shown, from 0 to 1.\n")
+	TEXT("Meant to be set per level in the FoliageQuality scalability group."),
+	FConsoleVariableDelegate::CreateStatic(&OnPlacementDensityScaleChanged),
+	ECVF_Scalability);
 
 UProceduralPlacementComponent::UProceduralPlacementComponent()
 {
-	PrimaryComponentTick.bCanEverTick = false;
+	// Only ticks while streaming at runtime
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UProceduralPlacementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bStreamAtRuntime)
+	{
+		StartStreaming();
+	}
+}
+
+void UProceduralPlacementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopStreaming();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UProceduralPlacementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (bStreaming)
+	{
+		UpdateStreaming();
+	}
+}
+
+namespace PlacementProgress
+{
+	// Share of the progress bar covered at the end of each stage
+	constexpr float SamplingEnd = 0.6f;
+	constexpr float ProjectionEnd = 0.95f;
+
+	// Serial sampler iterations between two progress/cancel checks
+	constexpr int32 CheckInterval = 256;
+}
+
+void UProceduralPlacementComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	BindSplineEvents();
+
+	// Compact and streaming zones do not save their instance component, it is rebuilt from the
+	// loaded Positions. Streaming zones clear their baked instances on BeginPlay anyway.
+	// Rebuilt in one call, a freshly loaded level must not fill in over several frames.
+	const bool bStreamsInThisWorld = bStreamAtRuntime && GetWorld() && GetWorld()->IsGameWorld();
+	if (!SavesInstanceComponents() && Positions.Num() > 0 && HasMesh() && Spline && !Spline->ISMComp && !bStreamsInThisWorld && !IsTemplate())
+	{
+		PrepareInstanceComponent();
+		SubmitInstances(nullptr, false);
+	}
+}
+
+// Positions are written quantized into StoredPositions and left out of the tagged properties.
+// Duplication archives are not persistent and still copy them at full precision, transactions skip them.
+// Cooked streaming zones save no points at all, their tiles are generated at runtime.
+
+void UProceduralPlacementComponent::Serialize(FArchive& Ar)
+{
+	const bool bCompact = bCompactStorage && Ar.IsPersistent() && !Ar.IsTransacting() && !HasAnyFlags(RF_ClassDefaultObject);
+	const bool bSkipPoints = bStreamAtRuntime && Ar.IsCooking();
+
+	TArray<FVector> SavedPositions;
+	if (Ar.IsSaving())
+	{
+		StoredPositions.Reset();
+		if (bSkipPoints)
+		{
+			SavedPositions = MoveTemp(Positions);
+		}
+		else if (bCompact)
+		{
+			StoredPositions.Encode(Positions, Spacing);
+			SavedPositions = MoveTemp(Positions);
+		}
+	}
+
+	Super::Serialize(Ar);
+
+	if (Ar.IsSaving() && (bCompact || bSkipPoints))
+	{
+		Positions = MoveTemp(SavedPositions);
+		StoredPositions.Reset();
+	}
+
+	if (Ar.IsLoading() && StoredPositions.Num() > 0)
+	{
+		StoredPositions.Decode(Positions);
+		StoredPositions.Reset();
+	}
+}
+
+void UProceduralPlacementComponent::OnUnregister()
+{
+	UnbindSplineEvents();
+
+	Super::OnUnregister();
+}
+
+void UProceduralPlacementComponent::BindSplineEvents()
+{
+	UnbindSplineEvents();
+
+	if (!Spline)
+	{
+		return;
+	}
+
+	BoundSpline = Spline;
+	SplineModifiedHandle = Spline->OnSplineModified.AddUObject(this, &UProceduralPlacementComponent::OnSplineModified);
+
+	for (USplineComponentPG* Exclusion : ExclusionSplines)
+	{
+		if (Exclusion && Exclusion != Spline)
+		{
+			BoundExclusionSplines.Emplace(Exclusion, Exclusion->OnSplineModified.AddUObject(this, &UProceduralPlacementComponent::OnSplineModified));
+		}
+	}
+}
+
+void UProceduralPlacementComponent::UnbindSplineEvents()
+{
+	if (USplineComponentPG* Bound = BoundSpline.Get())
+	{
+		Bound->OnSplineModified.Remove(SplineModifiedHandle);
+	}
+	BoundSpline.Reset();
+	SplineModifiedHandle.Reset();
+
+	for (const TPair<TWeakObjectPtr<USplineComponentPG>, FDelegateHandle>& Bound : BoundExclusionSplines)
+	{
+		if (USplineComponentPG* Exclusion = Bound.Key.Get())
+		{
+			Exclusion->OnSplineModified.Remove(Bound.Value);
+		}
+	}
+	BoundExclusionSplines.Reset();
+}
+
+void UProceduralPlacementComponent::OnSplineModified()
+{
+	if (bLivePreview)
+	{
+		RequestPreview();
+		return;
+	}
+
+	// Nothing to patch before the first generation, unless it is still running
+	if (!bRegenerateOnSplineEdit || (Tiles.Num() == 0 && !IsGenerating()))
+	{
+		return;
+	}
+
+	TilePatchRequestTime = FPlatformTime::Seconds();
+
+	if (!TilePatchTickerHandle.IsValid())
+	{
+		TilePatchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UProceduralPlacementComponent::TickTilePatch));
+	}
+}
+
+// Patches the zone once the spline stopped moving for PreviewDelay. Edits made while a
+// generation or its instance builder runs are kept and patched after it, against the
+// tiles it produced.
+
+bool UProceduralPlacementComponent::TickTilePatch(float DeltaTime)
+{
+	if (FPlatformTime::Seconds() - TilePatchRequestTime < PreviewDelay || IsGenerating())
+	{
+		return true;
+	}
+
+	TilePatchTickerHandle.Reset();
+
+	if (bRegenerateOnSplineEdit && !bLivePreview)
+	{
+		RegenerateChangedTiles();
+	}
+	return false;
+}
+
+// Streamed tiles are torn down by EndPlay and OnComponentDestroyed. Components must not be
+// destroyed during garbage collection, only the workers still using this are waited on.
+
+void UProceduralPlacementComponent::BeginDestroy()
+{
+	CancelGeneration();
+	WaitForStreamingRequests();
+	FTSTicker::GetCoreTicker().RemoveTicker(PreviewTickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(TilePatchTickerHandle);
+	Super::BeginDestroy();
+}
+
+void UProceduralPlacementComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+	CancelGeneration();
+	StopStreaming();
+	StopLivePreview();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TilePatchTickerHandle);
+	TilePatchTickerHandle.Reset();
+
+	Super::OnComponentDestroyed(bDestroyingHierarchy);
+}
+
+void UProceduralPlacementComponent::Generate()
+{
+	if (!HasMesh() || !Spline) return;
+
+	CancelGeneration();
+
+	if (bAsyncGeneration && !IsRunningCommandlet())
+	{
+		GenerateAsync();
+		return;
+	}
+
+	PrepareInstanceComponent();
+	GenerateFunction();
+}
+
+void UProceduralPlacementComponent::PrepareInstanceComponent()
+{
+	TArray<UStaticMesh*> Meshes;
+	TArray<float> CumulativeWeights;
+	GetMeshes(Meshes, CumulativeWeights);
+
+	Spline->ISMComp = PrepareMeshComponent(Spline->ISMComp, Meshes.Num() > 0 ? Meshes[0] : Mesh.Get());
+
+	for (int32 Index = FMath::Max(0, Meshes.Num() - 1); Index < PaletteComponents.Num(); Index++)
+	{
+		if (PaletteComponents[Index])
+		{
+			GetOwner()->RemoveInstanceComponent(PaletteComponents[Index]);
+			PaletteComponents[Index]->DestroyComponent();
+		}
+	}
+	PaletteComponents.SetNum(FMath::Max(0, Meshes.Num() - 1));
+
+	for (int32 Index = 1; Index < Meshes.Num(); Index++)
+	{
+		PaletteComponents[Index - 1] = PrepareMeshComponent(PaletteComponents[Index - 1], Meshes[Index]);
+	}
+}
+
+UInstancedStaticMeshComponent* UProceduralPlacementComponent::PrepareMeshComponent(UInstancedStaticMeshComponent* Component, UStaticMesh* ComponentMesh)
+{
+	if (Component)
+		Component->ClearInstances();
+	else
+	{
+		Component = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+		Component->SetupAttachment(GetOwner()->GetRootComponent());
+		Component->RegisterComponent();
+		Component->SetUsingAbsoluteLocation(false);
+	}
+
+	// Never part of a transaction, undo rebuilds the instances from GeneratedPointsKey
+	Component->ClearFlags(RF_Transactional);
+
+	UpdateMeshComponentStorage(Component);
+
+	Component->SetStaticMesh(ComponentMesh);
+	return Component;
+}
+
+void UProceduralPlacementComponent::UpdateMeshComponentStorage(UInstancedStaticMeshComponent* Component) const
+{
+	if (!SavesInstanceComponents())
+	{
+		Component->SetFlags(RF_Transient);
+		GetOwner()->RemoveInstanceComponent(Component);
+	}
+	else
+	{
+		Component->ClearFlags(RF_Transient);
+		GetOwner()->AddInstanceComponent(Component);
+	}
+}
+
+bool UProceduralPlacementComponent::HasMesh() const
+{
+	if (MeshPalette.Num() == 0)
+	{
+		return Mesh != nullptr;
+	}
+
+	return MeshPalette.ContainsByPredicate([](const FPlacementMeshEntry& Entry) { return Entry.Mesh && Entry.Weight > 0.0f; });
+}
+
+void UProceduralPlacementComponent::GetMeshes(TArray<UStaticMesh*>& OutMeshes, TArray<float>& OutCumulativeWeights) const
+{
+	OutMeshes.Reset();
+	OutCumulativeWeights.Reset();
+
+	if (MeshPalette.Num() == 0)
+	{
+		OutMeshes.Add(Mesh);
+		OutCumulativeWeights.Add(1.0f);
+		return;
+	}
+
+	float Total = 0.0f;
+	for (const FPlacementMeshEntry& Entry : MeshPalette)
+	{
+		if (Entry.Mesh && Entry.Weight > 0.0f)
+		{
+			Total += Entry.Weight;
+			OutMeshes.Add(Entry.Mesh);
+			OutCumulativeWeights.Add(Total);
+		}
+	}
+}
+
+void UProceduralPlacementComponent::GetInstanceComponents(TArray<UInstancedStaticMeshComponent*>& OutComponents) const
+{
+	OutComponents.Reset();
+
+	if (Spline && Spline->ISMComp)
+	{
+		OutComponents.Add(Spline->ISMComp);
+		for (UInstancedStaticMeshComponent* Component : PaletteComponents)
+		{
+			OutComponents.Add(Component);
+		}
+	}
+}
+
+void UProceduralPlacementComponent::ClearInstances()
+{
+	GeneratedPointsKey.Reset();
+
+	TArray<UInstancedStaticMeshComponent*> Components;
+	GetInstanceComponents(Components);
+
+	for (UInstancedStaticMeshComponent* Component : Components)
+	{
+		if (Component)
+		{
+			Component->ClearInstances();
+		}
+	}
+}
+
+// The pick only depends on Seed, Salt and the point index, so the same Positions always
+// split the same way and nothing per point has to be saved. Points keep their relative
+// order inside each group, which keeps the prefixes of progressive zones evenly spread.
+
+void UProceduralPlacementComponent::SplitByMesh(TConstArrayView<FVector> Points, int32 NumPoints, uint32 Salt, TArray<TArray<FTransform>>& OutTransforms) const
+{
+	TArray<UStaticMesh*> Meshes;
+	TArray<float> CumulativeWeights;
+	GetMeshes(Meshes, CumulativeWeights);
+
+	OutTransforms.SetNum(Meshes.Num());
+
+	if (Meshes.Num() == 1)
+	{
+		OutTransforms[0].Reset(NumPoints);
+		for (int32 i = 0; i < NumPoints; i++)
+		{
+			OutTransforms[0].Emplace(Points[i]);
+		}
+		return;
+	}
+
+	for (TArray<FTransform>& Transforms : OutTransforms)
+	{
+		Transforms.Reset(NumPoints * 2 / FMath::Max(1, Meshes.Num()));
+	}
+
+	const uint32 PickSeed = HashCombineFast(GetTypeHash(Seed), Salt);
+	const float Total = CumulativeWeights.Num() > 0 ? CumulativeWeights.Last() : 0.0f;
+
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		const uint32 Hash = MurmurFinalize32(HashCombineFast(PickSeed, uint32(i)));
+		const float Pick = (Hash >> 8) * (1.0f / 16777216.0f) * Total;
+
+		const int32 MeshIndex = FMath::Min(Algo::UpperBound(CumulativeWeights, Pick), Meshes.Num() - 1);
+		OutTransforms[MeshIndex].Emplace(Points[i]);
+	}
+}
+
+// Asynchronous pipeline.
+// Spline and landscape data are cached on the game thread, sampling and projection
+// run on a pool thread, and only the instance submission comes back to the game thread.
+// The previous instances stay visible until the new ones are ready.
+
+void UProceduralPlacementComponent::GenerateAsync(bool bPreview)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	FPlacementGenerationReport Report;
+
+	CacheSpline();
+	Report.CacheSplineMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	PrepareProjection();
+	const FString InputsKey = GetInputsKey();
+	const FString CacheKey = bUsePointCache ? InputsKey : FString();
+	const double PrepareMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 - Report.CacheSplineMs;
+
+	if (bPreview)
+	{
+		PreviewInputsKey = InputsKey;
+
+		TArray<FVector> CachedPoints;
+		if (!CacheKey.IsEmpty() && FPlacementPointCache::Load(CacheKey, CachedPoints))
+		{
+			Report.bFromPointCache = true;
+			Report.NumSampledPoints = CachedPoints.Num();
+			ShowPreview(MoveTemp(CachedPoints), Report, FProjectionBatchStats());
+			return;
+		}
+	}
+	else if (SubmitCachedPoints(CacheKey, Report, StartTime))
+	{
+		GeneratedPointsKey = InputsKey;
+		return;
+	}
+
+	TSharedRef<FPlacementGenerationTask> Task = MakeShared<FPlacementGenerationTask>();
+	Task->bPreview = bPreview;
+	ActiveTask = Task;
+
+	TWeakObjectPtr<UProceduralPlacementComponent> WeakThis(this);
+
+	// The component cancels and waits for this task before being destroyed
+	Task->Future = Async(EAsyncExecution::ThreadPool, [this, WeakThis, Task, Report, InputsKey, CacheKey, PrepareMs, StartTime, bPreview]() mutable
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PlacementGenerate);
+
+		double StageStart = FPlatformTime::Seconds();
+
+		TArray<FVector> Points;
+		PoissonDiskAlgo(Points);
+		SetGenerationProgress(PlacementProgress::SamplingEnd);
+
+		Report.SamplingMs = float((FPlatformTime::Seconds() - StageStart) * 1000.0);
+		Report.NumSampledPoints = Points.Num();
+		Report.SetSamplingStats(SamplingStats);
+
+		FProjectionBatchStats Projection;
+		if (!Task->bCancelled)
+		{
+			StageStart = FPlatformTime::Seconds();
+			ProjectPointArray(Points, &Projection);
+			OrderPointsProgressive(Points);
+			SetGenerationProgress(PlacementProgress::ProjectionEnd);
+			Report.ProjectionMs = float(PrepareMs + (FPlatformTime::Seconds() - StageStart) * 1000.0);
+		}
+
+		// Previews are thrown away at every edit, only committed point sets go to the cache
+		if (!Task->bCancelled && !bPreview && !CacheKey.IsEmpty())
+		{
+			FPlacementPointCache::Save(CacheKey, Points);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Task, Report, Projection, StartTime, bPreview, InputsKey = MoveTemp(InputsKey), Points = MoveTemp(Points)]() mutable
+		{
+			UProceduralPlacementComponent* This = WeakThis.Get();
+			if (!This || This->ActiveTask != Task)
+			{
+				return;
+			}
+
+			This->ActiveTask.Reset();
+
+			if (Task->bCancelled)
+			{
+				UE_LOG(LogProceduralPlacement, Log, TEXT("%s: generation cancelled"), *GetNameSafe(This->GetOwner()));
+				return;
+			}
+
+			if (bPreview)
+			{
+				This->ShowPreview(MoveTemp(Points), Report, Projection);
+				Task->Progress = 1.0f;
+				return;
+			}
+
+			const double SubmitStart = FPlatformTime::Seconds();
+			This->Positions = MoveTemp(Points);
+
+			// Only now the key describes the instances, a cancelled run leaves the old one
+			This->GeneratedPointsKey = MoveTemp(InputsKey);
+			This->PrepareInstanceComponent();
+			This->SubmitInstances([WeakThis, Report, Projection, StartTime, SubmitStart]() mutable
+			{
+				if (UProceduralPlacementComponent* Submitted = WeakThis.Get())
+				{
+					Report.SubmitMs = float((FPlatformTime::Seconds() - SubmitStart) * 1000.0);
+					Submitted->PublishReport(Report, Projection, StartTime);
+				}
+			});
+			Task->Progress = 1.0f;
+		});
+	});
+}
+
+// Live preview.
+// Edits only restart a short timer, the zone is resampled on a worker once they stop for
+// PreviewDelay. The result shows as at most MaxPreviewInstances transient instances of the
+// first mesh, and the zone's ISMs are only rebuilt by CommitPreview.
+
+void UProceduralPlacementComponent::StartLivePreview()
+{
+	if (bLivePreview)
+	{
+		return;
+	}
+
+	bLivePreview = true;
+
+	// Spline may have been assigned after the component was registered
+	BindSplineEvents();
+
+	PreviewTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UProceduralPlacementComponent::TickPreview));
+
+	// First preview on the next tick
+	bPreviewPending = true;
+	PreviewRequestTime = 0.0;
+}
+
+void UProceduralPlacementComponent::StopLivePreview()
+{
+	bLivePreview = false;
+	bPreviewPending = false;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(PreviewTickerHandle);
+	PreviewTickerHandle.Reset();
+
+	CancelPreviewTask();
+	PreviewPoints.Empty();
+
+	if (PreviewComponent)
+	{
+		PreviewComponent->DestroyComponent();
+		PreviewComponent = nullptr;
+	}
+}
+
+void UProceduralPlacementComponent::RequestPreview()
+{
+	if (bLivePreview)
+	{
+		bPreviewPending = true;
+		PreviewRequestTime = FPlatformTime::Seconds();
+	}
+}
+
+void UProceduralPlacementComponent::CommitPreview()
+{
+	if (!HasMesh() || !Spline) return;
+
+	const bool bPreviewSampling = ActiveTask && ActiveTask->bPreview;
+	if (!bLivePreview || bPreviewPending || bPreviewSampling || PreviewPoints.Num() == 0)
+	{
+		Generate();
+		return;
+	}
+
+	CancelGeneration();
+
+	const double StartTime = FPlatformTime::Seconds();
+	FPlacementGenerationReport Report = PreviewReport;
+	const FProjectionBatchStats Projection = PreviewProjection;
+	TWeakObjectPtr<UProceduralPlacementComponent> WeakThis(this);
+
+	Positions = PreviewPoints;
+	GeneratedPointsKey = PreviewInputsKey;
+	PrepareInstanceComponent();
+	SubmitInstances([WeakThis, Report, Projection, StartTime]() mutable
+	{
+		if (UProceduralPlacementComponent* Submitted = WeakThis.Get())
+		{
+			Report.SubmitMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+			Submitted->PublishReport(Report, Projection, StartTime);
+		}
+	});
+}
+
+bool UProceduralPlacementComponent::TickPreview(float DeltaTime)
+{
+	if (!bPreviewPending || FPlatformTime::Seconds() - PreviewRequestTime < PreviewDelay)
+	{
+		return true;
+	}
+
+	// A full generation owns the sampler, the preview follows once it is done
+	if (ActiveTask && !ActiveTask->bPreview)
+	{
+		return true;
+	}
+
+	bPreviewPending = false;
+	CancelPreviewTask();
+
+	if (HasMesh() && Spline)
+	{
+		GenerateAsync(true);
+	}
+	return true;
+}
+
+// Drops a preview still sampling, the instance builder of a commit keeps running
+
+void UProceduralPlacementComponent::CancelPreviewTask()
+{
+	if (!ActiveTask || !ActiveTask->bPreview)
+	{
+		return;
+	}
+
+	ActiveTask->bCancelled = true;
+	if (ActiveTask->Future.IsValid())
+	{
+		ActiveTask->Future.Wait();
+	}
+	ActiveTask.Reset();
+}
+
+void UProceduralPlacementComponent::ShowPreview(TArray<FVector>&& Points, const FPlacementGenerationReport& Report, const FProjectionBatchStats& Projection)
+{
+	PreviewPoints = MoveTemp(Points);
+	PreviewReport = Report;
+	PreviewProjection = Projection;
+
+	if (!bLivePreview || !GetOwner())
+	{
+		return;
+	}
+
+	TArray<UStaticMesh*> Meshes;
+	TArray<float> CumulativeWeights;
+	GetMeshes(Meshes, CumulativeWeights);
+
+	if (!PreviewComponent)
+	{
+		PreviewComponent = NewObject<UInstancedStaticMeshComponent>(GetOwner(), NAME_None, RF_Transient);
+		PreviewComponent->ClearFlags(RF_Transactional);
+		PreviewComponent->SetupAttachment(GetOwner()->GetRootComponent());
+		PreviewComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		PreviewComponent->SetCastShadow(false);
+		PreviewComponent->RegisterComponent();
+	}
+
+	PreviewComponent->SetStaticMesh(Meshes.Num() > 0 ? Meshes[0] : Mesh.Get());
+	PreviewComponent->ClearInstances();
+
+	const int32 Step = FMath::Max(1, FMath::DivideAndRoundUp(PreviewPoints.Num(), MaxPreviewInstances));
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(PreviewPoints.Num() / Step + 1);
+	for (int32 Index = 0; Index < PreviewPoints.Num(); Index += Step)
+	{
+		Transforms.Emplace(PreviewPoints[Index]);
+	}
+
+	PreviewComponent->AddInstances(Transforms, false, true);
+}
+
+void UProceduralPlacementComponent::CancelGeneration()
+{
+	if (InstanceBuilder)
+	{
+		InstanceBuilder->Cancel();
+		InstanceBuilder.Reset();
+	}
+
+	if (!ActiveTask)
+	{
+		return;
+	}
+
+	ActiveTask->bCancelled = true;
+	if (ActiveTask->Future.IsValid())
+	{
+		ActiveTask->Future.Wait();
+	}
+	ActiveTask.Reset();
+}
+
+bool UProceduralPlacementComponent::IsGenerating() const
+{
+	return ActiveTask.IsValid() || InstanceBuilder.IsValid();
+}
+
+float UProceduralPlacementComponent::GetGenerationProgress() const
+{
+	if (InstanceBuilder)
+	{
+		return FMath::Lerp(PlacementProgress::ProjectionEnd, 1.0f, InstanceBuilder->GetProgress());
+	}
+	return ActiveTask ? ActiveTask->Progress.load() : 0.0f;
+}
+
+bool UProceduralPlacementComponent::ShouldCancelGeneration() const
+{
+	return ActiveTask && ActiveTask->bCancelled;
+}
+
+void UProceduralPlacementComponent::SetGenerationProgress(float Progress) const
+{
+	if (ActiveTask)
+	{
+		ActiveTask->Progress = Progress;
+	}
+}
+
+// Rough Poisson disk point count, only used to scale the progress bar
+
+float UProceduralPlacementComponent::GetSamplingProgress(int32 NumPoints) const
+{
+	const double Expected = FMath::Max(1.0, ZoneArea * 0.75 / (Spacing * Spacing));
+	return PlacementProgress::SamplingEnd * FMath::Min(NumPoints / Expected, 0.99);
+}
+
+void UProceduralPlacementComponent::PublishReport(FPlacementGenerationReport& Report, const FProjectionBatchStats& Projection, double StartTime)
+{
+	Report.NumPolygonVertices = SplinePoints.Num();
+	Report.NumTraceHits = Projection.NumPoints - Projection.NumMisses - Projection.NumHeightfield;
+	Report.NumTraceMisses = Projection.NumMisses;
+	Report.NumHeightfieldHits = Projection.NumHeightfield;
+	Report.NumSlopeRejections = Projection.NumRejected;
+	TArray<UInstancedStaticMeshComponent*> Components;
+	GetInstanceComponents(Components);
+
+	Report.NumInstances = 0;
+	for (const UInstancedStaticMeshComponent* Component : Components)
+	{
+		Report.NumInstances += Component ? Component->GetInstanceCount() : 0;
+	}
+	Report.TotalMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	LastReport = Report;
+
+	SET_DWORD_STAT(STAT_PlacementCandidates, Report.NumCandidates);
+	SET_DWORD_STAT(STAT_PlacementSpacingRejections, Report.NumSpacingRejections);
+	SET_DWORD_STAT(STAT_PlacementOutsideRejections, Report.NumOutsideRejections);
+	SET_DWORD_STAT(STAT_PlacementLayerRejections, Report.NumLayerRejections);
+	SET_DWORD_STAT(STAT_PlacementPeakActivePoints, Report.PeakActivePoints);
+	SET_DWORD_STAT(STAT_PlacementTraceHits, Report.NumTraceHits);
+	SET_DWORD_STAT(STAT_PlacementTraceMisses, Report.NumTraceMisses);
+	SET_DWORD_STAT(STAT_PlacementHeightfieldHits, Report.NumHeightfieldHits);
+	SET_DWORD_STAT(STAT_PlacementSlopeRejections, Report.NumSlopeRejections);
+	SET_DWORD_STAT(STAT_PlacementInstances, Report.NumInstances);
+
+	UE_LOG(LogProceduralPlacement, Log, TEXT("%s: generation report\n%s"), *GetNameSafe(GetOwner()), *Report.ToString());
+}
+
+// Point cache.
+// The key covers everything sampling and projection read. Bump the version when
+// the output of the sampler or of the projection changes for the same inputs.
+
+namespace PlacementCacheKey
+{
+	constexpr uint32 Version = 3;
+}
+
+FString UProceduralPlacementComponent::GetPointCacheKey()
+{
+	return bUsePointCache ? GetInputsKey() : FString();
+}
+
+FString UProceduralPlacementComponent::GetInputsKey()
+{
+	FBlake3 Hasher;
+	auto Add = [&Hasher](const auto& Value)
+	{
+		Hasher.Update(&Value, sizeof(Value));
+	};
+
+	Add(PlacementCacheKey::Version);
+	Hasher.Update(SplinePoints.GetData(), SplinePoints.Num() * sizeof(FVector));
+	Add(Exclusions.Num());
+	Hasher.Update(Exclusions.GetVertices().GetData(), Exclusions.GetVertices().Num() * sizeof(FVector2D));
+	Add(Seed);
+	Add(Spacing);
+	Add(SamplingMode);
+	Add(SamplingTileSize);
+
+	if (SamplingMode == EPlacementSamplingMode::BlueNoiseTiles)
+	{
+		float TileSize;
+		const TArray<FBlueNoiseTile>& BlueNoiseTiles = GetBlueNoiseTiles(TileSize);
+		Add(TileSize);
+		for (const FBlueNoiseTile& Tile : BlueNoiseTiles)
+		{
+			Hasher.Update(Tile.Points.GetData(), Tile.Points.Num() * sizeof(FVector2f));
+		}
+	}
+
+	const FString MeshPath = GetPathNameSafe(Mesh);
+	Hasher.Update(*MeshPath, MeshPath.Len() * sizeof(TCHAR));
+
+	for (const FPlacementMeshEntry& Entry : MeshPalette)
+	{
+		const FString EntryPath = GetPathNameSafe(Entry.Mesh);
+		Hasher.Update(*EntryPath, EntryPath.Len() * sizeof(TCHAR));
+		Add(Entry.Weight);
+	}
+
+	Add(bProgressiveOrder);
+
+	if (LayerIndex)
+	{
+		Add(LayerRadius);
+		Hasher.Update(LayerIndex->GetPoints().GetData(), LayerIndex->GetPoints().Num() * sizeof(FVector2D));
+		Hasher.Update(LayerIndex->GetRadii().GetData(), LayerIndex->GetRadii().Num() * sizeof(float));
+	}
+
+	if (!SpacingMap.IsEmpty())
+	{
+		Add(SpacingMap.Origin);
+		Add(SpacingMap.CellSize);
+		Add(SpacingMap.Width);
+		Add(SpacingMap.Height);
+		Hasher.Update(SpacingMap.Spacings.GetData(), SpacingMap.Spacings.Num() * sizeof(float));
+	}
+	Add(ProjectionMode);
+	Add(MaxSlopeAngle);
+	Add(ProjectionHeightMargin);
+
+	if (ProjectionMode == EPlacementProjectionMode::LandscapeHeightfield)
+	{
+		Add(HeightSnapshot.Origin);
+		Add(HeightSnapshot.CellSize);
+		Add(HeightSnapshot.Width);
+		Add(HeightSnapshot.Height);
+		Hasher.Update(HeightSnapshot.Heights.GetData(), HeightSnapshot.Heights.Num() * sizeof(float));
+	}
+
+	// Line traces run in both modes, heightfield mode uses them off the landscape
+	AddProjectionTargets(Hasher);
+
+	return LexToString(Hasher.Finalize());
+}
+
+// Everything the projection rays can hit: world static primitives overlapping the zone
+// over the ray height range. Their transforms, bounds and assets are hashed, plus the
+// collision revision of landscape components, so moving a rock or sculpting changes the key.
+// Edits inside a mesh asset that keep its bounds are not seen.
+
+void UProceduralPlacementComponent::AddProjectionTargets(FBlake3& Hasher) const
+{
+	UWorld* World = GetWorld();
+	if (!World || !SplineBounds.IsValid)
+	{
+		return;
+	}
+
+	const FBox QueryBox(
+		FVector(SplineBounds.Min.X, SplineBounds.Min.Y, ProjectionHeightRange.X),
+		FVector(SplineBounds.Max.X, SplineBounds.Max.Y, ProjectionHeightRange.Y));
+
+	// The zone's own instances are rebuilt from the result, they must not feed the key
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProceduralPlacementCacheKey), false, GetOwner());
+
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByChannel(Overlaps, QueryBox.GetCenter(), FQuat::Identity, ECC_WorldStatic,
+		FCollisionShape::MakeBox(QueryBox.GetExtent()), QueryParams);
+
+	// Overlap order is not stable, the key must be
+	TArray<TPair<FString, const UPrimitiveComponent*>> Targets;
+	TSet<const UPrimitiveComponent*> Seen;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Component && !Seen.Contains(Component))
+		{
+			Seen.Add(Component);
+			Targets.Emplace(Component->GetPathName(), Component);
+		}
+	}
+	Targets.Sort([](const TPair<FString, const UPrimitiveComponent*>& A, const TPair<FString, const UPrimitiveComponent*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	auto Add = [&Hasher](const auto& Value)
+	{
+		Hasher.Update(&Value, sizeof(Value));
+	};
+
+	Add(Targets.Num());
+	for (const TPair<FString, const UPrimitiveComponent*>& Target : Targets)
+	{
+		const UPrimitiveComponent* Component = Target.Value;
+		const FTransform& Transform = Component->GetComponentTransform();
+		const FBox Bounds = Component->Bounds.GetBox();
+
+		Hasher.Update(*Target.Key, Target.Key.Len() * sizeof(TCHAR));
+		Add(Transform.GetLocation());
+		Add(Transform.GetRotation());
+		Add(Transform.GetScale3D());
+		Add(Bounds.Min);
+		Add(Bounds.Max);
+
+		if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			const FString MeshPath = GetPathNameSafe(MeshComponent->GetStaticMesh());
+			Hasher.Update(*MeshPath, MeshPath.Len() * sizeof(TCHAR));
+		}
+		else if (const ULandscapeHeightfieldCollisionComponent* Collision = Cast<ULandscapeHeightfieldCollisionComponent>(Component))
+		{
+			// Renewed every time the collision heights are rebuilt
+			Add(Collision->HeightfieldGuid);
+		}
+	}
+}
+
+bool UProceduralPlacementComponent::SubmitCachedPoints(const FString& Key, FPlacementGenerationReport& Report, double StartTime)
+{
+	if (Key.IsEmpty())
+	{
+		return false;
+	}
+
+	const double LoadStart = FPlatformTime::Seconds();
+
+	TArray<FVector> Points;
+	if (!FPlacementPointCache::Load(Key, Points))
+	{
+		return false;
+	}
+
+	Report.bFromPointCache = true;
+	Report.NumSampledPoints = Points.Num();
+	Report.SamplingMs = float((FPlatformTime::Seconds() - LoadStart) * 1000.0);
+
+	const double SubmitStart = FPlatformTime::Seconds();
+	TWeakObjectPtr<UProceduralPlacementComponent> WeakThis(this);
+
+	Positions = MoveTemp(Points);
+	PrepareInstanceComponent();
+	SubmitInstances([WeakThis, Report, StartTime, SubmitStart]() mutable
+	{
+		if (UProceduralPlacementComponent* Submitted = WeakThis.Get())
+		{
+			Report.SubmitMs = float((FPlatformTime::Seconds() - SubmitStart) * 1000.0);
+			Submitted->PublishReport(Report, FProjectionBatchStats(), StartTime);
+		}
+	});
+
+	return true;
+}
+
+void UProceduralPlacementComponent::ClearPointCache()
+{
+	FPlacementPointCache::Clear();
+}
+
+void UProceduralPlacementComponent::GenerateFunction()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlacementGenerate);
+
+	const double StartTime = FPlatformTime::Seconds();
+	double StageStart = StartTime;
+	auto Lap = [&StageStart]()
+	{
+		const double Now = FPlatformTime::Seconds();
+		const float Ms = float((Now - StageStart) * 1000.0);
+		StageStart = Now;
+		return Ms;
+	};
+
+	FPlacementGenerationReport Report;
+
+	Positions.Empty();
+	CacheSpline();
+	Report.CacheSplineMs = Lap();
+
+	PrepareProjection();
+	GeneratedPointsKey = GetInputsKey();
+	const FString CacheKey = bUsePointCache ? GeneratedPointsKey : FString();
+	const float PrepareMs = Lap();
+
+	if (SubmitCachedPoints(CacheKey, Report, StartTime))
+	{
+		return;
+	}
+	
+	PoissonDiskAlgo(Positions);
+	Report.SamplingMs = Lap();
+	Report.NumSampledPoints = Positions.Num();
+	Report.SetSamplingStats(SamplingStats);
+
+	FProjectionBatchStats Projection;
+	ProjectPointArray(Positions, &Projection);
+	OrderPointsProgressive(Positions);
+	Report.ProjectionMs = PrepareMs + Lap();
+
+	if (!CacheKey.IsEmpty())
+	{
+		FPlacementPointCache::Save(CacheKey, Positions);
+	}
+
+	const double SubmitStart = StageStart;
+	SubmitInstances([this, Report, Projection, StartTime, SubmitStart]() mutable
+	{
+		Report.SubmitMs = float((FPlatformTime::Seconds() - SubmitStart) * 1000.0);
+		PublishReport(Report, Projection, StartTime);
+	});
+}
+
+void UProceduralPlacementComponent::ApplyPoints(const TArray<FVector>& Points)
+{
+	// GenerateFunction samples straight into Positions, no copy needed then
+	if (&Points != &Positions)
+	{
+		Positions = Points;
+	}
+
+	ProjectPoints();
+	SubmitInstances();
+}
+
+// Builds every transform up front and hands them to the ISM in one batched call,
+// so per-instance buffers grow once and render state is only dirtied once.
+// When time sliced, the instance builder adds them in chunks over the next frames
+// instead; commandlets have no frames to spread over and always take the single call.
+
+void UProceduralPlacementComponent::SubmitInstances(TFunction<void()> OnSubmitted, bool bAllowTimeSlicing)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlacementSubmitInstances);
+
+	const bool bTimeSliced = bAllowTimeSlicing && bTimeSliceInstances && !IsRunningCommandlet();
+
+	TArray<TArray<FTransform>> Transforms;
+	SplitByMesh(Positions, GetDensityCount(Positions.Num()), 0, Transforms);
+
+	// Only the build order changes, Positions and the mesh picks stay in sampling order.
+	// Nearest first would undo the progressive order.
+	bInstancesReordered = bTimeSliced && bBuildNearestFirst && !bProgressiveOrder && SortNearestFirst(Transforms);
+
+	TArray<UInstancedStaticMeshComponent*> Components;
+	GetInstanceComponents(Components);
+	check(Components.Num() == Transforms.Num());
+
+	int32 NumInstances = 0;
+	for (const TArray<FTransform>& MeshTransforms : Transforms)
+	{
+		NumInstances += MeshTransforms.Num();
+	}
+
+	// With a single mesh and no nearest first ordering instance i is Positions[i], which the tile cache relies on
+	auto Finish = [this, OnSubmitted = MoveTemp(OnSubmitted)]()
+	{
+		InstanceBuilder.Reset();
+		RebuildTileCache();
+
+		if (OnSubmitted)
+		{
+			OnSubmitted();
+		}
+		OnInstancesBuilt.Broadcast();
+	};
+
+	if (!bTimeSliced || NumInstances <= InstanceChunkSize)
+	{
+		for (int32 Index = 0; Index < Components.Num(); Index++)
+		{
+			Components[Index]->AddInstances(Transforms[Index], false, true);
+		}
+		Finish();
+		return;
+	}
+
+	// Cancelled by CancelGeneration and when destroyed, so this cannot outlive the component
+	InstanceBuilder = MakeShared<FPlacementInstanceBuilder>(Components, MoveTemp(Transforms), InstanceBudgetMs, InstanceChunkSize);
+	InstanceBuilder->OnBuilt.BindLambda(MoveTemp(Finish));
+	InstanceBuilder->Start();
+}
+
+int32 UProceduralPlacementComponent::GetDensityCount(int32 NumPoints) const
+{
+	if (!bProgressiveOrder)
+	{
+		return NumPoints;
+	}
+
+	const float Scale = FMath::Clamp(DensityScale * GPlacementDensityScale, 0.0f, 1.0f);
+	return FMath::Min(NumPoints, FMath::CeilToInt32(NumPoints * Scale));
+}
+
+void UProceduralPlacementComponent::SetDensityScale(float NewDensityScale)
+{
+	DensityScale = FMath::Clamp(NewDensityScale, 0.0f, 1.0f);
+	ApplyDensityScale();
+}
+
+// The kept points are always a prefix of Positions, and each ISM holds its points of
+// that prefix in order, so a new scale only removes or appends at the end of each ISM.
+
+void UProceduralPlacementComponent::ApplyDensityScale()
+{
+	// A running generation picks the scale up when it submits
+	if (!bProgressiveOrder || !Spline || !Spline->ISMComp || IsGenerating())
+	{
+		return;
+	}
+
+	TArray<UInstancedStaticMeshComponent*> Components;
+	GetInstanceComponents(Components);
+
+	TArray<TArray<FTransform>> Transforms;
+	SplitByMesh(Positions, GetDensityCount(Positions.Num()), 0, Transforms);
+
+	if (Components.Num() != Transforms.Num())
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+	{
+		UInstancedStaticMeshComponent* ISM = Components[Index];
+		if (!ISM)
+		{
+			continue;
+		}
+
+		const TArray<FTransform>& Kept = Transforms[Index];
+		const int32 Current = ISM->GetInstanceCount();
+
+		if (Kept.Num() < Current)
+		{
+			TArray<int32> Tail;
+			Tail.Reserve(Current - Kept.Num());
+			for (int32 i = Current - 1; i >= Kept.Num(); i--)
+			{
+				Tail.Add(i);
+			}
+			ISM->RemoveInstances(Tail, true);
+		}
+		else if (Kept.Num() > Current)
+		{
+			const TArray<FTransform> Added(Kept.GetData() + Current, Kept.Num() - Current);
+			ISM->AddInstances(Added, false, true);
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UProceduralPlacementComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UProceduralPlacementComponent, DensityScale))
+	{
+		ApplyDensityScale();
+	}
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UProceduralPlacementComponent, bCompactStorage) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UProceduralPlacementComponent, bStreamAtRuntime))
+	{
+		TArray<UInstancedStaticMeshComponent*> Components;
+		GetInstanceComponents(Components);
+		for (UInstancedStaticMeshComponent* Component : Components)
+		{
+			UpdateMeshComponentStorage(Component);
+		}
+	}
+
+	RequestPreview();
+}
+
+// Generation transactions.
+// Instances and points never enter the transaction buffer, only the parameters and
+// GeneratedPointsKey do. Undo and redo swap the key back and the instances are rebuilt
+// from the point cache, or generated again from the restored parameters on a miss.
+
+void UProceduralPlacementComponent::PreEditUndo()
+{
+	Super::PreEditUndo();
+
+	KeyBeforeUndo = GeneratedPointsKey;
+}
+
+void UProceduralPlacementComponent::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// Parameter edits are undone without touching the instances
+	if (GeneratedPointsKey != KeyBeforeUndo)
+	{
+		RestoreGeneratedPoints();
+	}
+	KeyBeforeUndo.Reset();
+}
+#endif
+
+void UProceduralPlacementComponent::RestoreGeneratedPoints()
+{
+	CancelGeneration();
+
+	if (GeneratedPointsKey.IsEmpty() || !HasMesh() || !Spline)
+	{
+		ClearInstances();
+		return;
+	}
+
+	TArray<FVector> Points;
+	if (FPlacementPointCache::Load(GeneratedPointsKey, Points))
+	{
+		CacheSpline();
+		Positions = MoveTemp(Points);
+		PrepareInstanceComponent();
+		SubmitInstances();
+		return;
+	}
+
+	UE_LOG(LogProceduralPlacement, Log, TEXT("%s: points of the restored generation are not cached, generating them again"),
+		*GetNameSafe(GetOwner()));
+	Generate();
+}
+
+bool UProceduralPlacementComponent::SortNearestFirst(TArray<TArray<FTransform>>& Transforms) const
+{
+	UWorld* World = GetWorld();
+	if (!World || World->ViewLocationsRenderedLastFrame.Num() == 0)
+	{
+		return false;
+	}
+
+	const TArray<FVector>& Views = World->ViewLocationsRenderedLastFrame;
+	auto GetDistanceSquared = [&Views](const FVector& Point)
+	{
+		double Closest = TNumericLimits<double>::Max();
+		for (const FVector& View : Views)
+		{
+			Closest = FMath::Min(Closest, FVector::DistSquared2D(Point, View));
+		}
+		return Closest;
+	};
+
+	for (TArray<FTransform>& MeshTransforms : Transforms)
+	{
+		TArray<TPair<double, int32>> Order;
+		Order.Reserve(MeshTransforms.Num());
+		for (int32 i = 0; i < MeshTransforms.Num(); i++)
+		{
+			Order.Emplace(GetDistanceSquared(MeshTransforms[i].GetLocation()), i);
+		}
+		Order.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+		TArray<FTransform> Sorted;
+		Sorted.Reserve(MeshTransforms.Num());
+		for (const TPair<double, int32>& Entry : Order)
+		{
+			Sorted.Add(MeshTransforms[Entry.Value]);
+		}
+		MeshTransforms = MoveTemp(Sorted);
+	}
+	return true;
+}
+
+// Incremental regeneration.
+// Every tile keeps a hash of what its points depend on: the polygon edges within
+// Spacing of the tile, whether the tile center is inside, Seed and the tile layout.
+// After a spline edit only tiles whose hash changed are resampled, with the points of
+// the untouched tiles around them loaded in the grid as constraints, and only their
+// instances are updated, added or removed in the ISM.
+
+void UProceduralPlacementComponent::RegenerateChangedTiles()
+{
+	if (!HasMesh() || !Spline) return;
+
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
+
+	if (SamplingMode != EPlacementSamplingMode::TiledBridson || Tiles.Num() == 0 ||
+		TileCacheCellSize != CellSize || TileCacheTileCells != TileCells ||
+		!Spline->ISMComp || Spline->ISMComp->GetInstanceCount() != Positions.Num())
+	{
+		Generate();
+		return;
+	}
+
+	CancelGeneration();
+
+	SCOPE_CYCLE_COUNTER(STAT_PlacementRegenerateTiles);
+
+	const double StartTime = FPlatformTime::Seconds();
+	double StageStart = StartTime;
+	auto Lap = [&StageStart]()
+	{
+		const double Now = FPlatformTime::Seconds();
+		const float Ms = float((Now - StageStart) * 1000.0);
+		StageStart = Now;
+		return Ms;
+	};
+
+	FPlacementGenerationReport Report;
+
+	CacheSpline();
+	Report.CacheSplineMs = Lap();
+
+	// Every tile of the new zone, plus the old ones that may have to be emptied
+	TSet<FIntPoint> TileSet;
+	const FIntPoint FirstZoneTile = GetTileCoord(GetMinPoint(), TileWorld);
+	const FIntPoint LastZoneTile  = GetTileCoord(GetMaxPoint(), TileWorld);
+	for (int32 Y = FirstZoneTile.Y; Y <= LastZoneTile.Y; Y++)
+	{
+		for (int32 X = FirstZoneTile.X; X <= LastZoneTile.X; X++)
+		{
+			TileSet.Add(FIntPoint(X, Y));
+		}
+	}
+	for (const TPair<FIntPoint, FPlacementTile>& Pair : Tiles)
+	{
+		TileSet.Add(Pair.Key);
+	}
+
+	TArray<FIntPoint> WorldTiles = TileSet.Array();
+	TArray<uint32> Hashes;
+	ComputeTileHashes(WorldTiles, Hashes);
+
+	TArray<FIntPoint> DirtyTiles;
+	TMap<FIntPoint, uint32> DirtyHashes;
+	FIntPoint FirstDirty(TNumericLimits<int32>::Max());
+	FIntPoint LastDirty(TNumericLimits<int32>::Lowest());
+
+	for (int32 Index = 0; Index < WorldTiles.Num(); Index++)
+	{
+		const FPlacementTile* Existing = Tiles.Find(WorldTiles[Index]);
+		if (!Existing || Existing->InputHash != Hashes[Index])
+		{
+			DirtyTiles.Add(WorldTiles[Index]);
+			DirtyHashes.Add(WorldTiles[Index], Hashes[Index]);
+			FirstDirty = FirstDirty.ComponentMin(WorldTiles[Index]);
+			LastDirty  = LastDirty.ComponentMax(WorldTiles[Index]);
+		}
+	}
+
+	if (DirtyTiles.Num() == 0)
+	{
+		return;
+	}
+
+	// Deterministic sampling order whatever the TSet layout
+	DirtyTiles.Sort([](const FIntPoint& A, const FIntPoint& B)
+	{
+		return A.Y != B.Y ? A.Y < B.Y : A.X < B.X;
+	});
+
+	// Grid over the dirty tiles and one ring of neighbors holding the points we keep
+	const FIntPoint GridFirstTile = FirstDirty - FIntPoint(1, 1);
+	const FIntPoint GridLastTile  = LastDirty + FIntPoint(1, 1);
+
+	FPoissonSampleGrid Grid;
+	InitTileGrid(Grid, GridFirstTile, GridLastTile);
+
+	for (int32 Y = GridFirstTile.Y; Y <= GridLastTile.Y; Y++)
+	{
+		for (int32 X = GridFirstTile.X; X <= GridLastTile.X; X++)
+		{
+			const FPlacementTile* Kept = DirtyHashes.Contains(FIntPoint(X, Y)) ? nullptr : Tiles.Find(FIntPoint(X, Y));
+			if (!Kept)
+			{
+				continue;
+			}
+
+			for (const FVector& Point : Kept->Points)
+			{
+				int32 CX, CY;
+				if (Grid.GetCell(Point, CX, CY))
+				{
+					Grid.AddToSlot(Point, CX, CY);
+				}
+			}
+		}
+	}
+
+	TArray<TArray<FVector>> SampledTiles;
+	FPlacementSamplingStats Sampling;
+	SampleTilesInPhases(Grid, GridFirstTile, DirtyTiles, SampledTiles, Sampling);
+
+	TArray<FVector> NewPoints;
+	for (const TArray<FVector>& Sampled : SampledTiles)
+	{
+		NewPoints.Append(Sampled);
+	}
+
+	Report.SamplingMs = Lap();
+	Report.NumSampledPoints = NewPoints.Num();
+	Report.SetSamplingStats(Sampling);
+
+	const FBox2D DirtyRegion(
+		FVector2D(FirstDirty.X, FirstDirty.Y) * TileWorld,
+		FVector2D(LastDirty.X + 1, LastDirty.Y + 1) * TileWorld);
+	FProjectionBatchStats Projection;
+	PrepareProjection(&DirtyRegion);
+	ProjectPointArray(NewPoints, &Projection);
+	Report.ProjectionMs = Lap();
+
+	// Projection keeps XY, so points land back in the tile they were sampled in
+	TMap<FIntPoint, TArray<FVector>> ProjectedTiles;
+	for (const FVector& Point : NewPoints)
+	{
+		ProjectedTiles.FindOrAdd(GetTileCoord(Point, TileWorld)).Add(Point);
+	}
+
+	UInstancedStaticMeshComponent* ISM = Spline->ISMComp;
+
+	TArray<FTransform> Added;
+	TArray<FIntPoint> AddedTiles;
+	TArray<int32> Removed;
+
+	for (const FIntPoint& Coord : DirtyTiles)
+	{
+		FPlacementTile& Tile = Tiles.FindOrAdd(Coord);
+		TArray<FVector> Points = ProjectedTiles.FindRef(Coord);
+
+		const int32 NumReused = FMath::Min(Tile.InstanceIndices.Num(), Points.Num());
+		for (int32 i = 0; i < NumReused; i++)
+		{
+			const int32 Instance = Tile.InstanceIndices[i];
+			ISM->UpdateInstanceTransform(Instance, FTransform(Points[i]), true, false, true);
+			Positions[Instance] = Points[i];
+		}
+
+		for (int32 i = NumReused; i < Tile.InstanceIndices.Num(); i++)
+		{
+			Removed.Add(Tile.InstanceIndices[i]);
+		}
+		Tile.InstanceIndices.SetNum(NumReused);
+
+		for (int32 i = NumReused; i < Points.Num(); i++)
+		{
+			Added.Emplace(Points[i]);
+			AddedTiles.Add(Coord);
+		}
+
+		Tile.Points = MoveTemp(Points);
+		Tile.InputHash = DirtyHashes[Coord];
+	}
+
+	if (Added.Num() > 0)
+	{
+		const int32 FirstAdded = ISM->GetInstanceCount();
+		ISM->AddInstances(Added, false, true);
+
+		for (int32 i = 0; i < Added.Num(); i++)
+		{
+			Tiles[AddedTiles[i]].InstanceIndices.Add(FirstAdded + i);
+			Positions.Add(Added[i].GetLocation());
+		}
+	}
+
+	if (Removed.Num() > 0)
+	{
+		// The ISM keeps instance order on removal, so every later index moves down
+		Removed.Sort();
+		ISM->RemoveInstances(Removed);
+
+		int32 Write = 0;
+		int32 NextRemoved = 0;
+		for (int32 i = 0; i < Positions.Num(); i++)
+		{
+			if (NextRemoved < Removed.Num() && Removed[NextRemoved] == i)
+			{
+				NextRemoved++;
+				continue;
+			}
+			Positions[Write++] = Positions[i];
+		}
+		Positions.SetNum(Write, EAllowShrinking::No);
+
+		for (TPair<FIntPoint, FPlacementTile>& Pair : Tiles)
+		{
+			for (int32& Instance : Pair.Value.InstanceIndices)
+			{
+				Instance -= Algo::LowerBound(Removed, Instance);
+			}
+		}
+	}
+
+	// Empty tiles that left the zone are not worth tracking anymore
+	for (auto It = Tiles.CreateIterator(); It; ++It)
+	{
+		const FIntPoint& Coord = It.Key();
+		const bool bInZone =
+			Coord.X >= FirstZoneTile.X && Coord.X <= LastZoneTile.X &&
+			Coord.Y >= FirstZoneTile.Y && Coord.Y <= LastZoneTile.Y;
+
+		if (!bInZone && It.Value().Points.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	ISM->MarkRenderStateDirty();
+
+	// Undo records the key with the parameters, so it has to describe the patched points.
+	// Only the heightfield snapshot was limited to the dirty tiles, the rest is prepared.
+	if (ProjectionMode == EPlacementProjectionMode::LandscapeHeightfield)
+	{
+		PrepareProjection();
+	}
+	GeneratedPointsKey = GetInputsKey();
+
+	Report.SubmitMs = Lap();
+	PublishReport(Report, Projection, StartTime);
+
+	UE_LOG(LogProceduralPlacement, Log, TEXT("%s: regenerated %d of %d tiles (%d updated, %d added, %d removed instances) in %.2f ms"),
+		*GetNameSafe(GetOwner()), DirtyTiles.Num(), WorldTiles.Num(),
+		NewPoints.Num() - Added.Num(), Added.Num(), Removed.Num(),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UProceduralPlacementComponent::RebuildTileCache()
+{
+	Tiles.Reset();
+
+	// Patching tiles would break the progressive order, the mesh split, the variable spacing
+	// or miss changes of the lower layers, edits regenerate the whole zone instead.
+	// Patches also need instance i to be Positions[i], which nearest first ordering breaks.
+	if (SamplingMode != EPlacementSamplingMode::TiledBridson || SplinePoints.Num() == 0 || bProgressiveOrder || PaletteComponents.Num() > 0 || !SpacingMap.IsEmpty() || LayerIndex || bInstancesReordered)
+	{
+		return;
+	}
+
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(TileCacheCellSize, TileCells, TileWorld);
+	TileCacheTileCells = TileCells;
+
+	const FIntPoint FirstTile = GetTileCoord(GetMinPoint(), TileWorld);
+	const FIntPoint LastTile  = GetTileCoord(GetMaxPoint(), TileWorld);
+	for (int32 Y = FirstTile.Y; Y <= LastTile.Y; Y++)
+	{
+		for (int32 X = FirstTile.X; X <= LastTile.X; X++)
+		{
+			Tiles.Add(FIntPoint(X, Y));
+		}
+	}
+
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		FPlacementTile& Tile = Tiles.FindOrAdd(GetTileCoord(Positions[i], TileWorld));
+		Tile.Points.Add(Positions[i]);
+		Tile.InstanceIndices.Add(i);
+	}
+
+	TArray<FIntPoint> WorldTiles;
+	Tiles.GetKeys(WorldTiles);
+
+	TArray<uint32> Hashes;
+	ComputeTileHashes(WorldTiles, Hashes);
+
+	for (int32 Index = 0; Index < WorldTiles.Num(); Index++)
+	{
+		Tiles[WorldTiles[Index]].InputHash = Hashes[Index];
+	}
+}
+
+void UProceduralPlacementComponent::ComputeTileHashes(TConstArrayView<FIntPoint> WorldTiles, TArray<uint32>& OutHashes) const
+{
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
+
+	TMap<FIntPoint, int32> TileIndices;
+	TileIndices.Reserve(WorldTiles.Num());
+	for (int32 Index = 0; Index < WorldTiles.Num(); Index++)
+	{
+		TileIndices.Add(WorldTiles[Index], Index);
+	}
+
+	// Edges closer than Spacing to a tile can change which of its candidates get accepted
+	TArray<TArray<int32>> TileEdges;
+	TileEdges.SetNum(WorldTiles.Num());
+
+	const int32 N = SplinePoints.Num();
+	for (int32 i = 0; i < N; i++)
+	{
+		const FVector& P1 = SplinePoints[i];
+		const FVector& P2 = SplinePoints[(i + 1) % N];
+
+		const FIntPoint First = GetTileCoord(FVector(FMath::Min(P1.X, P2.X) - Spacing, FMath::Min(P1.Y, P2.Y) - Spacing, 0.0), TileWorld);
+		const FIntPoint Last  = GetTileCoord(FVector(FMath::Max(P1.X, P2.X) + Spacing, FMath::Max(P1.Y, P2.Y) + Spacing, 0.0), TileWorld);
+
+		for (int32 Y = First.Y; Y <= Last.Y; Y++)
+		{
+			for (int32 X = First.X; X <= Last.X; X++)
+			{
+				if (const int32* Index = TileIndices.Find(FIntPoint(X, Y)))
+				{
+					TileEdges[*Index].Add(i);
+				}
+			}
+		}
+	}
+
+	OutHashes.SetNumUninitialized(WorldTiles.Num());
+
+	for (int32 Index = 0; Index < WorldTiles.Num(); Index++)
+	{
+		const FIntPoint& Tile = WorldTiles[Index];
+
+		uint32 Hash = HashCombine(GetTypeHash(Seed), GetTypeHash(Spacing));
+		Hash = HashCombine(Hash, GetTypeHash(TileCells));
+
+		for (const int32 Edge : TileEdges[Index])
+		{
+			const FVector& P1 = SplinePoints[Edge];
+			const FVector& P2 = SplinePoints[(Edge + 1) % N];
+			Hash = HashCombine(Hash, GetTypeHash(FVector2D(P1.X, P1.Y)));
+			Hash = HashCombine(Hash, GetTypeHash(FVector2D(P2.X, P2.Y)));
+		}
+
+		const FBox2D TileBox(FVector2D(Tile.X * TileWorld - Spacing, Tile.Y * TileWorld - Spacing),
+			FVector2D((Tile.X + 1) * TileWorld + Spacing, (Tile.Y + 1) * TileWorld + Spacing));
+		Hash = HashCombine(Hash, Exclusions.GetOverlapHash(TileBox));
+
+		// Tiles no edge gets close to are entirely inside or outside
+		const FVector Center((Tile.X + 0.5) * TileWorld, (Tile.Y + 0.5) * TileWorld, 0.0);
+		Hash = HashCombine(Hash, GetTypeHash(IsInside(Center)));
+
+		OutHashes[Index] = Hash;
+	}
+}
+
+// Runtime streaming.
+// Tiles within StreamingRadius of a player view are sampled and projected on worker
+// threads, then get their own instance component on the game thread. Tiles further than
+// StreamingRadius + StreamingReleaseMargin are released. Applying and releasing stop
+// for the frame once StreamingFrameBudgetMs is spent. Tiles are sampled exactly as the
+// offline tiled or blue noise samplers would, so only the spline and the parameters
+// need to be shipped.
+
+void UProceduralPlacementComponent::StartStreaming()
+{
+	if (!HasMesh() || !Spline || bStreaming)
+	{
+		return;
+	}
+
+	// SamplingMode itself is left alone, it is what Generate uses in the editor
+	StreamingSamplingMode = SamplingMode;
+	if (StreamingSamplingMode == EPlacementSamplingMode::Bridson)
+	{
+		UE_LOG(LogProceduralPlacement, Warning, TEXT("%s: runtime streaming needs tiled sampling, streaming with TiledBridson"),
+			*GetNameSafe(GetOwner()));
+		StreamingSamplingMode = EPlacementSamplingMode::TiledBridson;
+	}
+
+	CancelGeneration();
+
+	ClearInstances();
+
+	CacheSpline();
+	PrepareProjection();
+
+	if (!SpacingMap.IsEmpty())
+	{
+		UE_LOG(LogProceduralPlacement, Warning, TEXT("%s: streamed tiles ignore the density source and use Spacing"),
+			*GetNameSafe(GetOwner()));
+	}
+
+	// Built here, workers must not create the default set concurrently
+	float TileSize;
+	GetBlueNoiseTiles(TileSize);
+
+	bStopStreaming = false;
+	bStreaming = true;
+	SetComponentTickEnabled(true);
+}
+
+void UProceduralPlacementComponent::StopStreaming()
+{
+	if (!bStreaming)
+	{
+		return;
+	}
+
+	WaitForStreamingRequests();
+
+	for (TPair<FIntPoint, FPlacementStreamedTile>& Pair : StreamedTiles)
+	{
+		for (UInstancedStaticMeshComponent* Component : Pair.Value.Components)
+		{
+			if (Component)
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+	StreamedTiles.Reset();
+
+	{
+		FScopeLock Lock(&SampledTileCacheLock);
+		SampledTileCache.Reset();
+	}
+
+	bStreaming = false;
+	SetComponentTickEnabled(false);
+}
+
+void UProceduralPlacementComponent::WaitForStreamingRequests()
+{
+	bStopStreaming = true;
+	for (FPlacementStreamingRequest& Request : StreamingRequests)
+	{
+		Request.Future.Wait();
+	}
+	StreamingRequests.Reset();
+}
+
+// Streamed tiles render and collide like the baked instances they replace. Compact zones
+// have no saved instance component to copy from at runtime, so tiles keep the defaults their
+// rebuilt instances get too.
+
+void UProceduralPlacementComponent::CopyStreamedTileSettings(UInstancedStaticMeshComponent* Component) const
+{
+	const UInstancedStaticMeshComponent* Baked = Spline ? Spline->ISMComp : nullptr;
+	if (!Baked)
+	{
+		return;
+	}
+
+	Component->SetCollisionProfileName(Baked->GetCollisionProfileName(), false);
+	Component->SetCollisionEnabled(Baked->GetCollisionEnabled());
+	Component->SetCollisionResponseToChannels(Baked->GetCollisionResponseToChannels());
+
+	Component->InstanceStartCullDistance = Baked->InstanceStartCullDistance;
+	Component->InstanceEndCullDistance = Baked->InstanceEndCullDistance;
+
+	Component->CastShadow = Baked->CastShadow;
+	Component->bCastDynamicShadow = Baked->bCastDynamicShadow;
+	Component->bCastStaticShadow = Baked->bCastStaticShadow;
+}
+
+void UProceduralPlacementComponent::UpdateStreaming()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProceduralPlacementComponent::UpdateStreaming);
+
+	const double Deadline = FPlatformTime::Seconds() + StreamingFrameBudgetMs / 1000.0;
+
+	const double TileWorld = GetStreamingTileWorld();
+	const FIntPoint FirstZoneTile = GetTileCoord(GetMinPoint(), TileWorld);
+	const FIntPoint LastZoneTile  = GetTileCoord(GetMaxPoint(), TileWorld);
+
+	TArray<FVector> Views;
+	GetStreamingViews(Views);
+
+	// Squared distance from the closest view to a tile
+	auto GetTileDistanceSquared = [&Views, TileWorld](const FIntPoint& Tile)
+	{
+		const FBox2D Box(FVector2D(Tile.X, Tile.Y) * TileWorld, FVector2D(Tile.X + 1, Tile.Y + 1) * TileWorld);
+		double Closest = TNumericLimits<double>::Max();
+		for (const FVector& View : Views)
+		{
+			Closest = FMath::Min(Closest, Box.ComputeSquaredDistanceToPoint(FVector2D(View)));
+		}
+		return Closest;
+	};
+
+	TArray<TPair<double, FIntPoint>> Wanted;
+	for (const FVector& View : Views)
+	{
+		const FIntPoint First = GetTileCoord(View - FVector(StreamingRadius), TileWorld).ComponentMax(FirstZoneTile);
+		const FIntPoint Last  = GetTileCoord(View + FVector(StreamingRadius), TileWorld).ComponentMin(LastZoneTile);
+
+		for (int32 Y = First.Y; Y <= Last.Y; Y++)
+		{
+			for (int32 X = First.X; X <= Last.X; X++)
+			{
+				const FIntPoint Tile(X, Y);
+				const double DistanceSquared = GetTileDistanceSquared(Tile);
+				if (DistanceSquared <= FMath::Square(StreamingRadius) &&
+					!StreamedTiles.Contains(Tile) &&
+					!StreamingRequests.ContainsByPredicate([&Tile](const FPlacementStreamingRequest& Request) { return Request.Tile == Tile; }) &&
+					!Wanted.ContainsByPredicate([&Tile](const TPair<double, FIntPoint>& Pair) { return Pair.Value == Tile; }))
+				{
+					Wanted.Emplace(DistanceSquared, Tile);
+				}
+			}
+		}
+	}
+
+	// Release far tiles first, they free memory for the new ones
+	const double ReleaseDistanceSquared = FMath::Square(StreamingRadius + StreamingReleaseMargin);
+	for (auto It = StreamedTiles.CreateIterator(); It && FPlatformTime::Seconds() < Deadline; ++It)
+	{
+		if (GetTileDistanceSquared(It.Key()) > ReleaseDistanceSquared)
+		{
+			for (UInstancedStaticMeshComponent* Component : It.Value().Components)
+			{
+				if (Component)
+				{
+					Component->DestroyComponent();
+				}
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	// Apply finished tiles, results of tiles that went out of range meanwhile are dropped
+	for (int32 Index = 0; Index < StreamingRequests.Num() && FPlatformTime::Seconds() < Deadline; )
+	{
+		FPlacementStreamingRequest& Request = StreamingRequests[Index];
+		if (!Request.Future.IsReady())
+		{
+			Index++;
+			continue;
+		}
+
+		const FIntPoint Tile = Request.Tile;
+		TArray<FVector> Points = Request.Future.Consume();
+		StreamingRequests.RemoveAtSwap(Index);
+
+		if (GetTileDistanceSquared(Tile) > ReleaseDistanceSquared)
+		{
+			continue;
+		}
+
+		// Streamed tiles take the density scale they are created with
+		TArray<TArray<FTransform>> Transforms;
+		SplitByMesh(Points, GetDensityCount(Points.Num()), GetTypeHash(Tile), Transforms);
+
+		TArray<UStaticMesh*> Meshes;
+		TArray<float> CumulativeWeights;
+		GetMeshes(Meshes, CumulativeWeights);
+
+		FPlacementStreamedTile& Streamed = StreamedTiles.Add(Tile);
+		for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); MeshIndex++)
+		{
+			if (Transforms[MeshIndex].Num() == 0)
+			{
+				continue;
+			}
+
+			UInstancedStaticMeshComponent* ISM = NewObject<UInstancedStaticMeshComponent>(GetOwner(), NAME_None, RF_Transient);
+			ISM->SetupAttachment(GetOwner()->GetRootComponent());
+			ISM->SetStaticMesh(Meshes[MeshIndex]);
+			CopyStreamedTileSettings(ISM);
+			ISM->RegisterComponent();
+			ISM->AddInstances(Transforms[MeshIndex], false, true);
+			Streamed.Components.Add(ISM);
+		}
+	}
+
+	// Nearest tiles first
+	Wanted.Sort([](const TPair<double, FIntPoint>& A, const TPair<double, FIntPoint>& B) { return A.Key < B.Key; });
+
+	for (const TPair<double, FIntPoint>& Pair : Wanted)
+	{
+		if (StreamingRequests.Num() >= MaxStreamingTasks)
+		{
+			break;
+		}
+
+		const FIntPoint Tile = Pair.Value;
+
+		// The component waits for every request in WaitForStreamingRequests before going away
+		FPlacementStreamingRequest& Request = StreamingRequests.AddDefaulted_GetRef();
+		Request.Tile = Tile;
+		Request.Future = Async(EAsyncExecution::ThreadPool, [this, Tile]()
+		{
+			return BuildStreamingTile(Tile);
+		});
+	}
+
+	// Sampled tiles only matter as constraints for tiles that may still be requested
+	const double KeepDistanceSquared = FMath::Square(StreamingRadius + StreamingReleaseMargin + 3.0 * TileWorld);
+	FScopeLock Lock(&SampledTileCacheLock);
+	for (auto It = SampledTileCache.CreateIterator(); It; ++It)
+	{
+		if (GetTileDistanceSquared(It.Key()) > KeepDistanceSquared)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UProceduralPlacementComponent::GetStreamingViews(TArray<FVector>& OutViews) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			OutViews.Add(Location);
+		}
+	}
+
+	if (OutViews.Num() == 0)
+	{
+		OutViews = World->ViewLocationsRenderedLastFrame;
+	}
+}
+
+double UProceduralPlacementComponent::GetStreamingTileWorld()
+{
+	if (StreamingSamplingMode == EPlacementSamplingMode::BlueNoiseTiles)
+	{
+		float TileSize;
+		GetBlueNoiseTiles(TileSize);
+		return double(TileSize) * Spacing;
+	}
+
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
+	return TileWorld;
+}
+
+TArray<FVector> UProceduralPlacementComponent::BuildStreamingTile(const FIntPoint& Tile)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProceduralPlacementComponent::BuildStreamingTile);
+
+	TArray<FVector> Points;
+	if (bStopStreaming)
+	{
+		return Points;
+	}
+
+	if (StreamingSamplingMode == EPlacementSamplingMode::BlueNoiseTiles)
+	{
+		float TileSize;
+		const TArray<FBlueNoiseTile>& Tiles = GetBlueNoiseTiles(TileSize);
+		FPlacementSamplingStats Stats;
+		StampBlueNoiseTile(Tile, Tiles, double(TileSize) * Spacing, Points, Stats);
+	}
+	else
+	{
+		GetSampledTile(Tile, Points);
+	}
+
+	if (!bStopStreaming)
+	{
+		ProjectPointArray(Points);
+		OrderPointsProgressive(Points);
+	}
+	return Points;
+}
+
+void UProceduralPlacementComponent::GetSampledTile(const FIntPoint& Tile, TArray<FVector>& OutPoints)
+{
+	{
+		FScopeLock Lock(&SampledTileCacheLock);
+		if (const TArray<FVector>* Cached = SampledTileCache.Find(Tile))
+		{
+			OutPoints = *Cached;
+			return;
+		}
+	}
+
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
+
+	auto GetPhase = [](const FIntPoint& Coord)
+	{
+		return (Coord.X & 1) | ((Coord.Y & 1) << 1);
+	};
+
+	FPoissonSampleGrid Grid;
+	InitTileGrid(Grid, Tile - FIntPoint(1, 1), Tile + FIntPoint(1, 1));
+
+	for (int32 Y = -1; Y <= 1; Y++)
+	{
+		for (int32 X = -1; X <= 1; X++)
+		{
+			const FIntPoint Neighbor = Tile + FIntPoint(X, Y);
+			if (Neighbor == Tile || GetPhase(Neighbor) > GetPhase(Tile))
+			{
+				continue;
+			}
+
+			TArray<FVector> NeighborPoints;
+			GetSampledTile(Neighbor, NeighborPoints);
+
+			for (const FVector& Point : NeighborPoints)
+			{
+				int32 CX, CY;
+				if (Grid.GetCell(Point, CX, CY))
+				{
+					Grid.AddToSlot(Point, CX, CY);
+				}
+			}
+		}
+	}
+
+	FPlacementSamplingStats Stats;
+	SampleTile(Grid, FIntPoint(1, 1), Tile, TileCells, OutPoints, Stats);
+
+	FScopeLock Lock(&SampledTileCacheLock);
+	SampledTileCache.Add(Tile, OutPoints);
+}
+
+// Generates evenly distributed points using Poisson Disk Sampling.
+// Ensures a minimum distance (Spacing) between points to avoid clustering.
+
+void UProceduralPlacementComponent::PoissonDiskAlgo(TArray<FVector>& Points)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlacementPoissonDisk);
+
+	SamplingStats = FPlacementSamplingStats();
+
+	if (!SpacingMap.IsEmpty())
+	{
+		PoissonDiskVariable(Points);
+		return;
+	}
+
+	if (SamplingMode == EPlacementSamplingMode::TiledBridson)
+	{
+		PoissonDiskTiled(Points);
+		return;
+	}
+
+	if (SamplingMode == EPlacementSamplingMode::BlueNoiseTiles)
+	{
+		PoissonDiskBlueNoise(Points);
+		return;
+	}
+
+	FRandomStream Random(Seed);
+
+	FVector Min = GetMinPoint();
+	FVector Max = GetMaxPoint();
+
+	float CellSIze = Spacing / FMath::Sqrt(2.f);
+
+	FPoissonSampleGrid Grid;
+	Grid.Init(Min, Max, CellSIze);
+
+	TArray<FVector> ActivePoints;
+	FPoissonCandidateBatch Batch;
+	
+	// The seed point is not registered in the grid, which keeps the output
+	// identical to what previous versions generated for the same Seed/Spacing.
+	// It still grows the zone when a lower layer or a hole covers it.
+	FVector FirstPoint = SplinePoints[0];
+	FirstPoint.Z = 0.f;
+
+	ActivePoints.Add(FirstPoint);
+	const bool bFirstPointPlaced = !IsBlockedByLayers(FirstPoint) && !Exclusions.IsExcluded(FVector2D(FirstPoint));
+	if (bFirstPointPlaced)
+	{
+		Points.Add(FirstPoint);
+	}
+
+	FPlacementSamplingStats& Stats = SamplingStats;
+	Stats.PeakActivePoints = 1;
+
+	// Holes wider than the annulus can split the zone into parts the growth from the seed
+	// never reaches. Once the active list runs out, growth restarts from the next free cell
+	// whose center is a valid point. Cells only ever fill up, so one pass over them is enough.
+	int32 ReseedCell = 0;
+	auto Reseed = [&]()
+	{
+		for (; ReseedCell < Grid.Cells.Num(); ReseedCell++)
+		{
+			if (Grid.Cells[ReseedCell] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 CX = ReseedCell % Grid.Width;
+			const int32 CY = ReseedCell / Grid.Width;
+			const FVector Center(Grid.Min.X + (CX + 0.5) * Grid.CellSize, Grid.Min.Y + (CY + 0.5) * Grid.CellSize, 0.0);
+
+			// The seed is not in the grid
+			const bool bNearFirstPoint = bFirstPointPlaced && FVector::DistSquared2D(Center, FirstPoint) < Spacing * Spacing;
+			if (bNearFirstPoint || Grid.HasNeighborWithin(Center, CX, CY, Spacing * Spacing) || IsBlockedByLayers(Center) || !IsInside(Center))
+			{
+				continue;
+			}
+
+			Points.Add(Center);
+			ActivePoints.Add(Center);
+			Grid.Add(Center, CX, CY);
+			return;
+		}
+	};
+	
+	int32 Iteration = 0;
+	while (ActivePoints.Num() > 0)
+	{
+		if (++Iteration % PlacementProgress::CheckInterval == 0)
+		{
+			if (ShouldCancelGeneration())
+			{
+				return;
+			}
+			SetGenerationProgress(GetSamplingProgress(Points.Num()));
+			TRACE_COUNTER_SET(PlacementActivePoints, ActivePoints.Num());
+		}
+
+		int32 Index = Random.RandRange(0, ActivePoints.Num() - 1);
+		FVector Current = ActivePoints[Index];
+		bool bFound = false;
+
+		// All 20 candidates are drawn and spacing-checked at once, then taken in order
+		Batch.Generate(Current, Spacing, Random);
+		const uint32 Crowded = Batch.FindCrowded(Grid, Spacing * Spacing);
+		int32 LastTried = FPoissonCandidateBatch::Num - 1;
+
+		for (int32 i = 0; i < FPoissonCandidateBatch::Num; i++)
+		{
+			const FVector Candidate = Batch.GetCandidate(i);
+
+			Stats.NumCandidates++;
+
+			int32 CX, CY;
+			if (!Grid.GetCell(Candidate, CX, CY) || (Crowded & (1u << i)))
+			{
+				Stats.NumSpacingRejections++;
+				continue;
+			}
+
+			if (IsBlockedByLayers(Candidate))
+			{
+				Stats.NumLayerRejections++;
+				continue;
+			}
+
+			if (!IsInside(Candidate))
+			{
+				Stats.NumOutsideRejections++;
+				continue;
+			}
+
+			Points.Add(Candidate);
+			ActivePoints.Add(Candidate);
+
+			Grid.Add(Candidate, CX, CY);
+			Stats.PeakActivePoints = FMath::Max(Stats.PeakActivePoints, ActivePoints.Num());
+			bFound = true;
+			LastTried = i;
+			break;
+		}
+
+		// Back to where drawing one candidate at a time would have stopped
+		Random = Batch.StreamAfter[LastTried];
+
+		if (!bFound)
+		{
+			ActivePoints.RemoveAt(Index);
+
+			// Without holes the output stays what previous versions generated
+			if (ActivePoints.Num() == 0 && !Exclusions.IsEmpty())
+			{
+				Reseed();
+			}
+		}
+	}
+
+	TRACE_COUNTER_SET(PlacementActivePoints, 0);
+}
+
+// Variable density sampling.
+// Same growth as the serial sampler, but the annulus around an active point uses the
+// spacing at that point and a candidate only has to be its own spacing away from the
+// accepted points. Radii read from SpacingMap, neighbors from a multi-level grid.
+
+void UProceduralPlacementComponent::PoissonDiskVariable(TArray<FVector>& Points)
+{
+	FRandomStream Random(Seed);
+
+	FPoissonRadiusGrid Grid;
+	Grid.Init(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max), SpacingMap.MinSpacing, SpacingMap.MaxSpacing);
+
+	TArray<FVector> ActivePoints;
+	FPoissonCandidateBatch Batch;
+
+	FVector FirstPoint = SplinePoints[0];
+	FirstPoint.Z = 0.f;
+
+	// Grows the zone even when a lower layer or a hole covers it
+	ActivePoints.Add(FirstPoint);
+	if (!IsBlockedByLayers(FirstPoint) && !Exclusions.IsExcluded(FVector2D(FirstPoint)))
+	{
+		Points.Add(FirstPoint);
+		Grid.Add(FVector2D(FirstPoint));
+	}
+
+	FPlacementSamplingStats& Stats = SamplingStats;
+	Stats.PeakActivePoints = 1;
+
+	// Same restart as the serial sampler, over a lattice of cells fine enough for the
+	// smallest spacing: a point inside a cell is always closer to its center than the spacing.
+	const double ReseedCellSize = SpacingMap.MinSpacing / UE_DOUBLE_SQRT_2;
+	const int64 ReseedWidth  = FMath::Max<int64>(1, FMath::CeilToInt64((SplineBounds.Max.X - SplineBounds.Min.X) / ReseedCellSize));
+	const int64 ReseedHeight = FMath::Max<int64>(1, FMath::CeilToInt64((SplineBounds.Max.Y - SplineBounds.Min.Y) / ReseedCellSize));
+	int64 ReseedCell = 0;
+	auto Reseed = [&]()
+	{
+		for (; ReseedCell < ReseedWidth * ReseedHeight; ReseedCell++)
+		{
+			const FVector2D Center(
+				SplineBounds.Min.X + (ReseedCell % ReseedWidth + 0.5) * ReseedCellSize,
+				SplineBounds.Min.Y + (ReseedCell / ReseedWidth + 0.5) * ReseedCellSize);
+			const FVector Candidate(Center, 0.0);
+
+			if (!Grid.IsInBounds(Center) || Grid.HasNeighborWithin(Center, SpacingMap.GetSpacing(Center)) || IsBlockedByLayers(Candidate) || !IsInside(Candidate))
+			{
+				continue;
+			}
+
+			Points.Add(Candidate);
+			ActivePoints.Add(Candidate);
+			Grid.Add(Center);
+			return;
+		}
+	};
+
+	int32 Iteration = 0;
+	while (ActivePoints.Num() > 0)
+	{
+		if (++Iteration % PlacementProgress::CheckInterval == 0)
+		{
+			if (ShouldCancelGeneration())
+			{
+				return;
+			}
+			SetGenerationProgress(GetSamplingProgress(Points.Num()));
+			TRACE_COUNTER_SET(PlacementActivePoints, ActivePoints.Num());
+		}
+
+		const int32 Index = Random.RandRange(0, ActivePoints.Num() - 1);
+		const FVector Current = ActivePoints[Index];
+		bool bFound = false;
+
+		Batch.Generate(Current, SpacingMap.GetSpacing(FVector2D(Current)), Random);
+		int32 LastTried = FPoissonCandidateBatch::Num - 1;
+
+		for (int32 i = 0; i < FPoissonCandidateBatch::Num; i++)
+		{
+			const FVector Candidate = Batch.GetCandidate(i);
+			const FVector2D CandidateXY(Candidate);
+
+			Stats.NumCandidates++;
+
+			if (!Grid.IsInBounds(CandidateXY) || !IsInside(Candidate))
+			{
+				Stats.NumOutsideRejections++;
+				continue;
+			}
+
+			if (Grid.HasNeighborWithin(CandidateXY, SpacingMap.GetSpacing(CandidateXY)))
+			{
+				Stats.NumSpacingRejections++;
+				continue;
+			}
+
+			if (IsBlockedByLayers(Candidate))
+			{
+				Stats.NumLayerRejections++;
+				continue;
+			}
+
+			Points.Add(Candidate);
+			ActivePoints.Add(Candidate);
+
+			Grid.Add(CandidateXY);
+			Stats.PeakActivePoints = FMath::Max(Stats.PeakActivePoints, ActivePoints.Num());
+			bFound = true;
+			LastTried = i;
+			break;
+		}
+
+		Random = Batch.StreamAfter[LastTried];
+
+		if (!bFound)
+		{
+			ActivePoints.RemoveAtSwap(Index);
+
+			if (ActivePoints.Num() == 0 && !Exclusions.IsEmpty())
+			{
+				Reseed();
+			}
+		}
+	}
+
+	TRACE_COUNTER_SET(PlacementActivePoints, 0);
+}
+
+namespace PlacementDensity
+{
+	// Past this many cells the spacing map gets coarser than Spacing
+	constexpr int64 MaxCells = 2048 * 2048;
+
+	// Grey levels of the first mip in [0, 1], false when the format or the data is not readable
+	bool ReadTexture(UTexture2D* Texture, TArray<float>& OutValues, int32& OutWidth, int32& OutHeight)
+	{
+		auto Convert = [&OutValues](const uint8* Data, int64 NumPixels, int32 Stride, int32 Offset)
+		{
+			OutValues.SetNumUninitialized(NumPixels);
+			for (int64 i = 0; i < NumPixels; i++)
+			{
+				OutValues[i] = Data[i * Stride + Offset] / 255.0f;
+			}
+		};
+
+#if WITH_EDITORONLY_DATA
+		if (Texture->Source.IsValid())
+		{
+			const ETextureSourceFormat Format = Texture->Source.GetFormat();
+			TArray64<uint8> Data;
+			if ((Format == TSF_G8 || Format == TSF_BGRA8) && Texture->Source.GetMipData(Data, 0))
+			{
+				OutWidth = Texture->Source.GetSizeX();
+				OutHeight = Texture->Source.GetSizeY();
+				Convert(Data.GetData(), int64(OutWidth) * OutHeight, Format == TSF_G8 ? 1 : 4, Format == TSF_G8 ? 0 : 2);
+				return true;
+			}
+		}
+#endif
+
+		const FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+		if (!PlatformData || PlatformData->Mips.Num() == 0 ||
+			(PlatformData->PixelFormat != PF_G8 && PlatformData->PixelFormat != PF_B8G8R8A8))
+		{
+			return false;
+		}
+
+		const FTexture2DMipMap& Mip = PlatformData->Mips[0];
+		const uint8* Data = static_cast<const uint8*>(Mip.BulkData.LockReadOnly());
+		if (Data)
+		{
+			OutWidth = Mip.SizeX;
+			OutHeight = Mip.SizeY;
+			const bool bGrey = PlatformData->PixelFormat == PF_G8;
+			Convert(Data, int64(OutWidth) * OutHeight, bGrey ? 1 : 4, bGrey ? 0 : 2);
+		}
+		Mip.BulkData.Unlock();
+
+		return Data != nullptr;
+	}
+
+	// Distance from every cell center to the closest polygon edge.
+	// Cells crossed by an edge start with that edge, then a forward and a backward raster
+	// sweep hand the closest edge found so far to the next cells, which measure their exact
+	// distance to it. Close to exact for polygons whose edges are longer than a cell.
+	void ComputeEdgeDistances(const TArray<FVector>& Polygon, const FPlacementSpacingMap& Map, TArray<float>& OutDistances)
+	{
+		const int32 W = Map.Width;
+		const int32 H = Map.Height;
+		const int32 N = Polygon.Num();
+
+		TArray<int32> Closest;
+		Closest.Init(INDEX_NONE, W * H);
+		OutDistances.Init(TNumericLimits<float>::Max(), W * H);
+
+		auto Try = [&](int32 X, int32 Y, int32 Edge)
+		{
+			if (Edge == INDEX_NONE)
+			{
+				return;
+			}
+
+			const int32 Cell = Y * W + X;
+			const FVector Center(Map.GetCellCenter(X, Y), 0.0);
+			const FVector A(Polygon[Edge].X, Polygon[Edge].Y, 0.0);
+			const FVector B(Polygon[(Edge + 1) % N].X, Polygon[(Edge + 1) % N].Y, 0.0);
+
+			const float Distance = float(FMath::PointDistToSegment(Center, A, B));
+			if (Distance < OutDistances[Cell])
+			{
+				OutDistances[Cell] = Distance;
+				Closest[Cell] = Edge;
+			}
+		};
+
+		for (int32 Edge = 0; Edge < N; Edge++)
+		{
+			const FVector2D A(Polygon[Edge]);
+			const FVector2D B(Polygon[(Edge + 1) % N]);
+			const int32 Steps = FMath::Max(1, FMath::CeilToInt32(FVector2D::Distance(A, B) * 2.0 / Map.CellSize));
+
+			for (int32 Step = 0; Step <= Steps; Step++)
+			{
+				const FVector2D Local = (FMath::Lerp(A, B, double(Step) / Steps) - Map.Origin) / Map.CellSize;
+				const int32 X = FMath::FloorToInt32(Local.X);
+				const int32 Y = FMath::FloorToInt32(Local.Y);
+				if (X >= 0 && X < W && Y >= 0 && Y < H)
+				{
+					Try(X, Y, Edge);
+				}
+			}
+		}
+
+		auto Pass = [&](int32 X, int32 Y, int32 DX, int32 DY)
+		{
+			const int32 NX = X + DX;
+			const int32 NY = Y + DY;
+			if (NX >= 0 && NX < W && NY >= 0 && NY < H)
+			{
+				Try(X, Y, Closest[NY * W + NX]);
+			}
+		};
+
+		for (int32 Y = 0; Y < H; Y++)
+		{
+			for (int32 X = 0; X < W; X++)
+			{
+				Pass(X, Y, -1, 0);
+				Pass(X, Y, -1, -1);
+				Pass(X, Y, 0, -1);
+				Pass(X, Y, 1, -1);
+			}
+		}
+
+		for (int32 Y = H - 1; Y >= 0; Y--)
+		{
+			for (int32 X = W - 1; X >= 0; X--)
+			{
+				Pass(X, Y, 1, 0);
+				Pass(X, Y, 1, 1);
+				Pass(X, Y, 0, 1);
+				Pass(X, Y, -1, 1);
+			}
+		}
+	}
+}
+
+// Density source to spacing.
+// The source value of every map cell goes through DensityCurve, and the density
+// picks the spacing between MaxSpacing (0) and Spacing (1).
+
+void UProceduralPlacementComponent::BuildSpacingMap()
+{
+	SpacingMap.Reset();
+
+	if (DensitySource == EPlacementDensitySource::None || MaxSpacing <= Spacing || Spacing <= 0.0f || SplinePoints.Num() < 3)
+	{
+		return;
+	}
+
+	if (SamplingMode != EPlacementSamplingMode::Bridson)
+	{
+		UE_LOG(LogProceduralPlacement, Log, TEXT("%s: variable density uses the serial Bridson sampler"), *GetNameSafe(GetOwner()));
+	}
+
+	const FBox2D Bounds(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max));
+	const FVector2D Size = Bounds.GetSize();
+
+	double CellSize = Spacing;
+	while (int64(FMath::CeilToInt(Size.X / CellSize)) * int64(FMath::CeilToInt(Size.Y / CellSize)) > PlacementDensity::MaxCells)
+	{
+		CellSize *= 2.0;
+	}
+	SpacingMap.Init(Bounds, CellSize);
+
+	// Source value of every cell
+	TArray<float> Values;
+	bool bHasValues = false;
+
+	switch (DensitySource)
+	{
+	case EPlacementDensitySource::Texture:
+		{
+			TArray<float> Texels;
+			int32 TextureWidth = 0;
+			int32 TextureHeight = 0;
+
+			if (!DensityTexture || !PlacementDensity::ReadTexture(DensityTexture, Texels, TextureWidth, TextureHeight))
+			{
+				UE_LOG(LogProceduralPlacement, Warning, TEXT("%s: density texture missing or not readable (G8 or BGRA8, uncompressed), using full density"),
+					*GetNameSafe(GetOwner()));
+				break;
+			}
+
+			Values.SetNumUninitialized(SpacingMap.Spacings.Num());
+			ParallelFor(SpacingMap.Height, [&](int32 Y)
+			{
+				for (int32 X = 0; X < SpacingMap.Width; X++)
+				{
+					const FVector2D UV = (SpacingMap.GetCellCenter(X, Y) - Bounds.Min) / Size;
+					const FVector2D Texel = UV * FVector2D(TextureWidth, TextureHeight) - FVector2D(0.5);
+
+					const int32 X0 = FMath::Clamp(FMath::FloorToInt32(Texel.X), 0, TextureWidth - 1);
+					const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(Texel.Y), 0, TextureHeight - 1);
+					const int32 X1 = FMath::Min(X0 + 1, TextureWidth - 1);
+					const int32 Y1 = FMath::Min(Y0 + 1, TextureHeight - 1);
+
+					Values[Y * SpacingMap.Width + X] = FMath::BiLerp(
+						Texels[Y0 * TextureWidth + X0], Texels[Y0 * TextureWidth + X1],
+						Texels[Y1 * TextureWidth + X0], Texels[Y1 * TextureWidth + X1],
+						FMath::Clamp(float(Texel.X - X0), 0.0f, 1.0f), FMath::Clamp(float(Texel.Y - Y0), 0.0f, 1.0f));
+				}
+			});
+			bHasValues = true;
+		}
+		break;
+
+	case EPlacementDensitySource::EdgeDistance:
+		PlacementDensity::ComputeEdgeDistances(SplinePoints, SpacingMap, Values);
+		bHasValues = true;
+		break;
+
+	case EPlacementDensitySource::Slope:
+		if (HeightSnapshot.IsEmpty())
+		{
+			break;
+		}
+
+		Values.SetNumUninitialized(SpacingMap.Spacings.Num());
+		ParallelFor(SpacingMap.Height, [&](int32 Y)
+		{
+			for (int32 X = 0; X < SpacingMap.Width; X++)
+			{
+				FVector Normal;
+				const bool bOnLandscape = HeightSnapshot.SampleNormal(SpacingMap.GetCellCenter(X, Y), Normal);
+				Values[Y * SpacingMap.Width + X] = bOnLandscape ? float(FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Normal.Z, -1.0, 1.0)))) : 0.0f;
+			}
+		});
+		bHasValues = true;
+		break;
+
+	default:
+		break;
+	}
+
+	const FRichCurve* Curve = DensityCurve.GetRichCurveConst();
+	const bool bUseCurve = Curve && Curve->GetNumKeys() > 0;
+	const bool bRawDensity = DensitySource == EPlacementDensitySource::Texture;
+
+	ParallelFor(SpacingMap.Height, [&](int32 Y)
+	{
+		for (int32 X = 0; X < SpacingMap.Width; X++)
+		{
+			const int32 Cell = Y * SpacingMap.Width + X;
+
+			float Density = 1.0f;
+			if (bHasValues && bUseCurve)
+			{
+				Density = Curve->Eval(Values[Cell]);
+			}
+			else if (bHasValues && bRawDensity)
+			{
+				Density = Values[Cell];
+			}
+
+			SpacingMap.Spacings[Cell] = FMath::Lerp(MaxSpacing, Spacing, FMath::Clamp(Density, 0.0f, 1.0f));
+		}
+	});
+
+	SpacingMap.UpdateRange();
+}
+
+// Layered placement.
+// The points of the lower layers of the group go into one index over the zone, which the
+// samplers query right after their spacing check, so a layer grows around the ones placed
+// before it without any scene query. Every point of a lower zone counts, whatever DensityScale.
+
+void UProceduralPlacementComponent::BuildLayerIndex()
+{
+	if (SharedLayerIndex)
+	{
+		LayerIndex = SharedLayerIndex->IsEmpty() ? nullptr : SharedLayerIndex;
+		return;
+	}
+
+	LayerIndex.Reset();
+
+	if (LayerGroup.IsNone() || SplinePoints.Num() < 3)
+	{
+		return;
+	}
+
+	TArray<UProceduralPlacementComponent*> Zones;
+	GetLayerZones(Zones);
+
+	TArray<UProceduralPlacementComponent*> LowerZones;
+	float MaxRadius = LayerRadius;
+
+	for (UProceduralPlacementComponent* Zone : Zones)
+	{
+		if (Zone->LayerOrder < LayerOrder && Zone->Positions.Num() > 0)
+		{
+			LowerZones.Add(Zone);
+			MaxRadius = FMath::Max(MaxRadius, Zone->LayerRadius);
+		}
+	}
+
+	if (LowerZones.Num() == 0)
+	{
+		return;
+	}
+
+	TSharedRef<FPlacementLayerIndex> Index = MakeShared<FPlacementLayerIndex>();
+	Index->Init(FBox2D(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max)), MaxRadius);
+
+	for (const UProceduralPlacementComponent* Zone : LowerZones)
+	{
+		Index->Add(Zone->Positions, Zone->LayerRadius);
+	}
+
+	if (!Index->IsEmpty())
+	{
+		LayerIndex = Index;
+	}
+}
+
+void UProceduralPlacementComponent::GetLayerZones(TArray<UProceduralPlacementComponent*>& OutZones) const
+{
+	OutZones.Reset();
+
+	UWorld* World = GetWorld();
+	if (!World || LayerGroup.IsNone())
+	{
+		return;
+	}
+
+	for (TObjectIterator<UProceduralPlacementComponent> It(RF_ClassDefaultObject | RF_ArchetypeObject); It; ++It)
+	{
+		if (It->GetWorld() == World && It->LayerGroup == LayerGroup && It->IsRegistered())
+		{
+			OutZones.Add(*It);
+		}
+	}
+
+	// The path name breaks ties, so zones of one order always generate in the same sequence
+	OutZones.Sort([](const UProceduralPlacementComponent& A, const UProceduralPlacementComponent& B)
+	{
+		return A.LayerOrder != B.LayerOrder ? A.LayerOrder < B.LayerOrder : A.GetPathName() < B.GetPathName();
+	});
+}
+
+void UProceduralPlacementComponent::GenerateLayerGroup()
+{
+	if (LayerGroup.IsNone())
+	{
+		Generate();
+		return;
+	}
+
+	TArray<UProceduralPlacementComponent*> Zones;
+	GetLayerZones(Zones);
+
+	FBox2D Bounds(ForceInit);
+	float MaxRadius = 0.0f;
+
+	for (UProceduralPlacementComponent* Zone : Zones)
+	{
+		Zone->CancelGeneration();
+		Zone->CacheSpline();
+
+		if (Zone->SplinePoints.Num() > 0)
+		{
+			Bounds += FBox2D(FVector2D(Zone->SplineBounds.Min), FVector2D(Zone->SplineBounds.Max));
+		}
+		MaxRadius = FMath::Max(MaxRadius, Zone->LayerRadius);
+	}
+
+	// Layers are generated on the game thread one after the other, each reading the index
+	// while it samples and adding its points once every zone of its order is done
+	TSharedRef<FPlacementLayerIndex> Index = MakeShared<FPlacementLayerIndex>();
+	Index->Init(Bounds, MaxRadius);
+
+	int32 First = 0;
+	while (First < Zones.Num())
+	{
+		int32 End = First + 1;
+		while (End < Zones.Num() && Zones[End]->LayerOrder == Zones[First]->LayerOrder)
+		{
+			End++;
+		}
+
+		for (int32 ZoneIndex = First; ZoneIndex < End; ZoneIndex++)
+		{
+			UProceduralPlacementComponent* Zone = Zones[ZoneIndex];
+			if (!Zone->HasMesh() || !Zone->Spline)
+			{
+				continue;
+			}
+
+			// Records the key of every zone when called within a transaction
+			Zone->Modify();
+			Zone->SharedLayerIndex = Index;
+			Zone->PrepareInstanceComponent();
+			Zone->GenerateFunction();
+			Zone->SharedLayerIndex.Reset();
+		}
+
+		for (int32 ZoneIndex = First; ZoneIndex < End; ZoneIndex++)
+		{
+			Index->Add(Zones[ZoneIndex]->Positions, Zones[ZoneIndex]->LayerRadius);
+		}
+
+		First = End;
+	}
+}
+
+// Tiled variant of the sampler.
+// Tiles are aligned on the sampling grid and processed in four color phases, so tiles
+// running concurrently are never adjacent and only read cells finished in earlier phases.
+// Each tile draws from its own stream (Seed + world tile coordinate), which keeps the
+// result identical whatever the number of worker threads.
+
+void UProceduralPlacementComponent::PoissonDiskTiled(TArray<FVector>& Points)
+{
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
+
+	const FIntPoint FirstTile = GetTileCoord(GetMinPoint(), TileWorld);
+	const FIntPoint LastTile  = GetTileCoord(GetMaxPoint(), TileWorld);
+
+	FPoissonSampleGrid Grid;
+	InitTileGrid(Grid, FirstTile, LastTile);
+
+	TArray<FIntPoint> WorldTiles;
+	for (int32 Y = FirstTile.Y; Y <= LastTile.Y; Y++)
+	{
+		for (int32 X = FirstTile.X; X <= LastTile.X; X++)
+		{
+			WorldTiles.Add(FIntPoint(X, Y));
+		}
+	}
+
+	TArray<TArray<FVector>> TilePoints;
+	SampleTilesInPhases(Grid, FirstTile, WorldTiles, TilePoints, SamplingStats);
+
+	int32 NumPoints = Points.Num();
+	for (const TArray<FVector>& Tile : TilePoints)
+	{
+		NumPoints += Tile.Num();
+	}
+	Points.Reserve(NumPoints);
+
+	for (const TArray<FVector>& Tile : TilePoints)
+	{
+		Points.Append(Tile);
+	}
+}
+
+// Blue noise stamping.
+// The zone is covered with world-aligned tiles of TileSize * Spacing, every tile takes
+// the variant picked by hashing Seed with its coordinate, and only the containment test
+// runs per point. Rows of tiles are independent and stamped in parallel.
+
+void UProceduralPlacementComponent::PoissonDiskBlueNoise(TArray<FVector>& Points)
+{
+	float TileSize;
+	const TArray<FBlueNoiseTile>& Tiles = GetBlueNoiseTiles(TileSize);
+	if (Tiles.Num() == 0 || Spacing <= 0.0f)
+	{
+		return;
+	}
+
+	const double TileWorld = double(TileSize) * Spacing;
+	const FIntPoint FirstTile = GetTileCoord(GetMinPoint(), TileWorld);
+	const FIntPoint LastTile  = GetTileCoord(GetMaxPoint(), TileWorld);
+	const int32 NumRows = LastTile.Y - FirstTile.Y + 1;
+
+	TArray<TArray<FVector>> RowPoints;
+	TArray<FPlacementSamplingStats> RowStats;
+	RowPoints.SetNum(NumRows);
+	RowStats.SetNum(NumRows);
+
+	std::atomic<int32> RowsDone = 0;
+
+	ParallelFor(NumRows, [&](int32 Row)
+	{
+		if (ShouldCancelGeneration())
+		{
+			return;
+		}
+
+		for (int32 TileX = FirstTile.X; TileX <= LastTile.X; TileX++)
+		{
+			StampBlueNoiseTile(FIntPoint(TileX, FirstTile.Y + Row), Tiles, TileWorld, RowPoints[Row], RowStats[Row]);
+		}
+
+		SetGenerationProgress(PlacementProgress::SamplingEnd * ++RowsDone / NumRows);
+	});
+
+	int32 NumPoints = Points.Num();
+	for (int32 Row = 0; Row < NumRows; Row++)
+	{
+		NumPoints += RowPoints[Row].Num();
+		SamplingStats.Merge(RowStats[Row]);
+	}
+	Points.Reserve(NumPoints);
+
+	for (const TArray<FVector>& Row : RowPoints)
+	{
+		Points.Append(Row);
+	}
 }
 
-void UProceduralPlacementComponent::BeginPlay()
+void UProceduralPlacementComponent::StampBlueNoiseTile(const FIntPoint& WorldTile, TConstArrayView<FBlueNoiseTile> Tiles, double TileWorld, TArray<FVector>& OutPoints, FPlacementSamplingStats& OutStats) const
 {
-	Super::BeginPlay();
+	const uint32 Hash = HashCombine(GetTypeHash(Seed), GetTypeHash(WorldTile));
+	const FBlueNoiseTile& Tile = Tiles[Hash % Tiles.Num()];
+	const FVector Origin(WorldTile.X * TileWorld, WorldTile.Y * TileWorld, 0.0);
+
+	for (const FVector2f& Point : Tile.Points)
+	{
+		const FVector Candidate = Origin + FVector(Point.X, Point.Y, 0.0) * Spacing;
+
+		OutStats.NumCandidates++;
+		if (IsBlockedByLayers(Candidate))
+		{
+			OutStats.NumLayerRejections++;
+		}
+		else if (IsInside(Candidate))
+		{
+			OutPoints.Add(Candidate);
+		}
+		else
+		{
+			OutStats.NumOutsideRejections++;
+		}
+	}
 }
 
-void UProceduralPlacementComponent::Generate()
+const TArray<FBlueNoiseTile>& UProceduralPlacementComponent::GetBlueNoiseTiles(float& OutTileSize)
 {
-	if (!Mesh || !Spline) return;
+	if (BlueNoiseTileSet && BlueNoiseTileSet->Tiles.Num() > 0)
+	{
+		OutTileSize = BlueNoiseTileSet->TileSize;
+		return BlueNoiseTileSet->Tiles;
+	}
 
-	if (Spline->ISMComp)
-		Spline->ISMComp->ClearInstances();
-	else
+	const UBlueNoiseTileSet* Defaults = GetDefault<UBlueNoiseTileSet>();
+	if (DefaultBlueNoiseTiles.Num() == 0)
 	{
-		Spline->ISMComp	 =
-		NewObject<UInstancedStaticMeshComponent>(GetOwner());
-		Spline->ISMComp->SetupAttachment(GetOwner()->GetRootComponent());
-		Spline->ISMComp->RegisterComponent();
-		Spline->ISMComp->SetUsingAbsoluteLocation(false);
+		UBlueNoiseTileSet::BuildTiles(Defaults->NumTiles, Defaults->TileSize, Defaults->GeneratorSeed, DefaultBlueNoiseTiles);
 	}
 
-	Spline->ISMComp->SetStaticMesh(Mesh);  
-	GenerateFunction();
+	OutTileSize = Defaults->TileSize;
+	return DefaultBlueNoiseTiles;
 }
 
-void UProceduralPlacementComponent::GenerateFunction()
+void UProceduralPlacementComponent::GetTileLayout(float& OutCellSize, int32& OutTileCells, double& OutTileWorld) const
 {
-	Positions.Empty();
-	CacheSpline();
-	
-	PoissonDiskAlgo(Positions);
-	ApplyPoints(Positions);
+	OutCellSize = Spacing / FMath::Sqrt(2.f);
+
+	// Tiles of the same phase are one tile apart, 8 cells keeps every neighbor read
+	// (up to 5 cells out for a candidate batch) outside of them
+	OutTileCells = FMath::Max(8, FMath::FloorToInt(SamplingTileSize / OutCellSize));
+	OutTileWorld = double(OutTileCells) * OutCellSize;
 }
 
-void UProceduralPlacementComponent::ApplyPoints(const TArray<FVector>& Points)
+FIntPoint UProceduralPlacementComponent::GetTileCoord(const FVector& Point, double TileWorld)
 {
-	Positions = Points;
+	return FIntPoint(FMath::FloorToInt(Point.X / TileWorld), FMath::FloorToInt(Point.Y / TileWorld));
+}
 
-	ProjectPoints();
+void UProceduralPlacementComponent::InitTileGrid(FPoissonSampleGrid& Grid, const FIntPoint& FirstTile, const FIntPoint& LastTile) const
+{
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
 
-	for (const FVector& Pos : Positions)
-	{
-		Spline->ISMComp->AddInstanceWorldSpace(FTransform(Pos));
-	}
+	const FIntPoint NumTiles = LastTile - FirstTile + FIntPoint(1, 1);
+	Grid.InitSlotted(FVector2D(FirstTile.X, FirstTile.Y) * TileWorld, CellSize, NumTiles.X * TileCells, NumTiles.Y * TileCells);
 }
 
-// Generates evenly distributed points using Poisson Disk Sampling.
-// Ensures a minimum distance (Spacing) between points to avoid clustering.
+// Samples WorldTiles in four phases by tile parity, OutPoints[i] receives the points of WorldTiles[i].
+// Grid must have been set up by InitTileGrid with GridFirstTile as its first tile.
 
-void UProceduralPlacementComponent::PoissonDiskAlgo(TArray<FVector>& Points)
+void UProceduralPlacementComponent::SampleTilesInPhases(FPoissonSampleGrid& Grid, const FIntPoint& GridFirstTile, TConstArrayView<FIntPoint> WorldTiles, TArray<TArray<FVector>>& OutPoints, FPlacementSamplingStats& OutStats) const
 {
-	FRandomStream Random(Seed);
+	float CellSize;
+	int32 TileCells;
+	double TileWorld;
+	GetTileLayout(CellSize, TileCells, TileWorld);
 
-	FVector Min = GetMinPoint();
-	FVector Max = GetMaxPoint();
+	OutPoints.SetNum(WorldTiles.Num());
 
-	float CellSIze = Spacing / FMath::Sqrt(2.f);
+	TArray<FPlacementSamplingStats> TileStats;
+	TileStats.SetNum(WorldTiles.Num());
 
-	const int32 GridWidth  = FMath::CeilToInt((Max.X - Min.X) / CellSIze);
-	const int32 GridHeight = FMath::CeilToInt((Max.Y - Min.Y) / CellSIze);
-	TArray<FGridCell> Grids;
-	
-	Grids.SetNum(GridWidth);
-	
-	for (int32 X = 0; X < GridWidth; X++)
+	std::atomic<int32> TilesDone = 0;
+
+	TArray<int32> PhaseTiles;
+	for (int32 Phase = 0; Phase < 4; Phase++)
+	{
+		PhaseTiles.Reset();
+		for (int32 Index = 0; Index < WorldTiles.Num(); Index++)
+		{
+			if (((WorldTiles[Index].X & 1) | ((WorldTiles[Index].Y & 1) << 1)) == Phase)
+			{
+				PhaseTiles.Add(Index);
+			}
+		}
+
+		ParallelFor(PhaseTiles.Num(), [&](int32 PhaseIndex)
+		{
+			if (ShouldCancelGeneration())
+			{
+				return;
+			}
+
+			const int32 Index = PhaseTiles[PhaseIndex];
+			SampleTile(Grid, WorldTiles[Index] - GridFirstTile, WorldTiles[Index], TileCells, OutPoints[Index], TileStats[Index]);
+
+			SetGenerationProgress(PlacementProgress::SamplingEnd * ++TilesDone / WorldTiles.Num());
+		});
+	}
+
+	OutStats = FPlacementSamplingStats();
+	for (const FPlacementSamplingStats& Stats : TileStats)
 	{
-		Grids[X].PointsIndex.Init(-1, GridHeight);
+		OutStats.Merge(Stats);
 	}
+}
+
+// Fills one tile: every empty cell of the tile seeds a Bridson front that is not
+// allowed to leave the tile, so disconnected parts of the zone get covered as well.
+
+void UProceduralPlacementComponent::SampleTile(FPoissonSampleGrid& Grid, const FIntPoint& LocalTile, const FIntPoint& WorldTile, int32 TileCells, TArray<FVector>& OutPoints, FPlacementSamplingStats& OutStats) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProceduralPlacementComponent::SampleTile);
+
+	FRandomStream Random(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(WorldTile))));
+
+	const int32 MinCellX = LocalTile.X * TileCells;
+	const int32 MinCellY = LocalTile.Y * TileCells;
+	const double TileWorld = double(TileCells) * Grid.CellSize;
+	const float SpacingSquared = Spacing * Spacing;
 
 	TArray<FVector> ActivePoints;
-	
-	FVector FirstPoint = SplinePoints[0];
-	FirstPoint.Z = 0.f;
+	FPoissonCandidateBatch Batch;
 
-	ActivePoints.Add(FirstPoint);
-	Points.Add(FirstPoint);
-	
-	while (ActivePoints.Num() > 0)
+	// bCrowded is only read when bCrowdedKnown is set, otherwise the grid is queried
+	auto TryAdd = [&](const FVector& Candidate, bool bCrowdedKnown, bool bCrowded) -> bool
 	{
-		int32 Index = Random.RandRange(0, ActivePoints.Num() - 1);
-		FVector Current = ActivePoints[Index];
-		bool bFound = false;
+		OutStats.NumCandidates++;
+
+		int32 CX, CY;
+		if (!Grid.GetCell(Candidate, CX, CY) ||
+			CX < MinCellX || CX >= MinCellX + TileCells ||
+			CY < MinCellY || CY >= MinCellY + TileCells ||
+			GetTileCoord(Candidate, TileWorld) != WorldTile)
+		{
+			OutStats.NumOutsideRejections++;
+			return false;
+		}
+
+		if (bCrowdedKnown ? bCrowded : Grid.HasNeighborWithin(Candidate, CX, CY, SpacingSquared))
+		{
+			OutStats.NumSpacingRejections++;
+			return false;
+		}
+
+		if (IsBlockedByLayers(Candidate))
+		{
+			OutStats.NumLayerRejections++;
+			return false;
+		}
+
+		if (!IsInside(Candidate))
+		{
+			OutStats.NumOutsideRejections++;
+			return false;
+		}
+
+		Grid.AddToSlot(Candidate, CX, CY);
+		OutPoints.Add(Candidate);
+		ActivePoints.Add(Candidate);
+		OutStats.PeakActivePoints = FMath::Max(OutStats.PeakActivePoints, ActivePoints.Num());
+		return true;
+	};
 
-		for (int32 i = 0; i < 20; i++)
+	for (int32 Y = MinCellY; Y < MinCellY + TileCells; Y++)
+	{
+		for (int32 X = MinCellX; X < MinCellX + TileCells; X++)
 		{
-			float Angle = Random.FRandRange(0, TWO_PI);
-			float Dist  = Random.FRandRange(Spacing, Spacing * 2);
+			if (Grid.Cells[Grid.GetCellIndex(X, Y)] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			for (int32 Attempt = 0; Attempt < 4; Attempt++)
+			{
+				const FVector Candidate(
+					Grid.Min.X + (X + Random.FRand()) * Grid.CellSize,
+					Grid.Min.Y + (Y + Random.FRand()) * Grid.CellSize,
+					0.f);
 
-			FVector Candidate =
-				Current +
-				FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Dist;
+				if (TryAdd(Candidate, false, false))
+				{
+					break;
+				}
+			}
 
-			if (IsValid(Candidate, Points, Max, Min, CellSIze, Grids))
+			while (ActivePoints.Num() > 0)
 			{
-				if (IsInside(Candidate))
+				const int32 Index = Random.RandRange(0, ActivePoints.Num() - 1);
+				const FVector Current = ActivePoints[Index];
+				bool bFound = false;
+
+				Batch.Generate(Current, Spacing, Random);
+				const uint32 Crowded = Batch.FindCrowded(Grid, SpacingSquared);
+				int32 LastTried = FPoissonCandidateBatch::Num - 1;
+
+				for (int32 i = 0; i < FPoissonCandidateBatch::Num; i++)
 				{
-					Points.Add(Candidate);
-					ActivePoints.Add(Candidate);
+					if (TryAdd(Batch.GetCandidate(i), true, (Crowded & (1u << i)) != 0))
+					{
+						bFound = true;
+						LastTried = i;
+						break;
+					}
+				}
 
-					const FVector Local = Candidate - Min;
-					float CX = FMath::FloorToInt(Local.X / CellSIze);
-					float CY = FMath::FloorToInt(Local.Y / CellSIze);
+				Random = Batch.StreamAfter[LastTried];
 
-					Grids[CX].PointsIndex[CY] = Points.Num() - 1;
-					bFound = true;
-					break;
+				if (!bFound)
+				{
+					ActivePoints.RemoveAtSwap(Index);
 				}
 			}
 		}
+	}
+}
 
-		if (!bFound)
+namespace PlacementProgressive
+{
+	// The first level keeps points Spacing * Sqrt2^NumLevels apart, about 1/64 of them
+	constexpr int32 NumLevels = 6;
+}
+
+// Progressive order.
+// Points are emitted level by level, the radius going from Spacing * Sqrt2^NumLevels down
+// to Spacing. A level emits, in a seeded random order, every remaining point at least its
+// radius away from the points already emitted, so each level roughly doubles the density
+// and any prefix is a Poisson set over the whole zone. The last level takes what is left.
+
+void UProceduralPlacementComponent::OrderPointsProgressive(TArray<FVector>& Points) const
+{
+	if (!bProgressiveOrder || Points.Num() < 2 || Spacing <= 0.0f)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProceduralPlacementComponent::OrderPointsProgressive);
+
+	const FBox Bounds(Points);
+	FRandomStream Random(Seed);
+
+	TArray<int32> Remaining;
+	Remaining.SetNumUninitialized(Points.Num());
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		Remaining[i] = i;
+	}
+	for (int32 i = Remaining.Num() - 1; i > 0; i--)
+	{
+		Remaining.Swap(i, Random.RandRange(0, i));
+	}
+
+	TArray<FVector> Ordered;
+	Ordered.Reserve(Points.Num());
+
+	FPoissonSampleGrid Grid;
+
+	for (int32 Level = PlacementProgressive::NumLevels; Level > 0 && Remaining.Num() > 0; Level--)
+	{
+		const float Radius = Spacing * FMath::Pow(UE_SQRT_2, float(Level));
+		const float CellSize = Radius / UE_SQRT_2;
+		Grid.Init(Bounds.Min, Bounds.Max + FVector(CellSize), CellSize);
+
+		int32 CellX, CellY;
+		for (const FVector& Point : Ordered)
 		{
-			ActivePoints.RemoveAt(Index);
+			if (Grid.GetCell(Point, CellX, CellY))
+			{
+				Grid.Add(Point, CellX, CellY);
+			}
+		}
+
+		int32 NumKept = 0;
+		for (const int32 Index : Remaining)
+		{
+			const FVector& Point = Points[Index];
+			if (Grid.GetCell(Point, CellX, CellY) && !Grid.HasNeighborWithin(Point, CellX, CellY, Radius * Radius))
+			{
+				Grid.Add(Point, CellX, CellY);
+				Ordered.Add(Point);
+			}
+			else
+			{
+				Remaining[NumKept++] = Index;
+			}
 		}
+		Remaining.SetNum(NumKept, EAllowShrinking::No);
+	}
+
+	for (const int32 Index : Remaining)
+	{
+		Ordered.Add(Points[Index]);
 	}
+	Points = MoveTemp(Ordered);
+}
+
+namespace PlacementProjection
+{
+	// Sampled points sit at Z = 0, rays used to go from +5000 to -5000 around them
+	constexpr double MinTraceHalfHeight = 5000.0;
 }
 
 // Projects generated points onto the world geometry using line traces.
 // This allows points to conform to terrain elevation.
+// Traces are read-only scene queries, so batches run on worker threads.
+// In heightfield mode points over the landscape are placed from the snapshot instead.
 
 void UProceduralPlacementComponent::ProjectPoints()
 {
-	for (int i = 0; i < Positions.Num(); ++i)
-	{
-		FHitResult Hit;
-		FVector Start = Positions[i] + FVector(0,0,5000);
-		FVector End   = Positions[i] - FVector(0,0,5000);
+	PrepareProjection();
+	ProjectPointArray(Positions);
+}
+
+void UProceduralPlacementComponent::PrepareProjection(const FBox2D* Region)
+{
+	HeightSnapshot.Reset();
+
+	// Iterates the landscape actors, so it is done here on the game thread and never by the workers
+	ProjectionHeightRange = ComputeProjectionHeightRange();
 
-		if (GetWorld()->LineTraceSingleByChannel(
-			Hit, Start, End, ECC_WorldStatic))
+	const bool bSlopeDensity = !Region && DensitySource == EPlacementDensitySource::Slope;
+
+	if (ProjectionMode == EPlacementProjectionMode::LandscapeHeightfield || bSlopeDensity)
+	{
+		const FBox2D ZoneXY = Region ? *Region : FBox2D(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max));
+		if (!HeightSnapshot.Build(GetWorld(), ZoneXY))
 		{
-			Positions[i] = Hit.Location;
+			UE_LOG(LogProceduralPlacement, Warning, TEXT("%s: no landscape under the zone, falling back to line traces"),
+				*GetNameSafe(GetOwner()));
 		}
 	}
+
+	if (!Region)
+	{
+		BuildSpacingMap();
+		BuildLayerIndex();
+	}
 }
 
+void UProceduralPlacementComponent::ProjectPointArray(TArray<FVector>& Points, FProjectionBatchStats* OutTotals) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlacementProjectPoints);
 
-// Checks whether a candidate point respects the minimum spacing constraint
-// by inspecting neighboring grid cells only (O(1) average complexity).
+	UWorld* World = GetWorld();
+	if (!World || Points.Num() == 0)
+	{
+		return;
+	}
 
-bool UProceduralPlacementComponent::IsValid(FVector Candidate, TArray<FVector>& Points, FVector Max, FVector Min, float CellSIze, TArray<FGridCell> Grids)
-{
-	if (Candidate.X < Min.X || Candidate.X > Max.X ||
-		Candidate.Y < Min.Y || Candidate.Y > Max.Y)
+	const FVector2D HeightRange = ProjectionHeightRange;
+	// The previous instances stay in place while a generation or a tile patch projects,
+	// rays must reach the ground under them. Same actor the cache key leaves out.
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProceduralPlacementProjection), false, GetOwner());
+
+	const bool bUseHeightfield = ProjectionMode == EPlacementProjectionMode::LandscapeHeightfield && !HeightSnapshot.IsEmpty();
+	const bool bFilterSlope = MaxSlopeAngle < 90.0f;
+	const double MinNormalZ = FMath::Cos(FMath::DegreesToRadians(MaxSlopeAngle));
+
+	TArray<bool> Rejected;
+	if (bFilterSlope)
 	{
-		return false;
+		Rejected.Init(false, Points.Num());
 	}
 
-	const FVector Local = Candidate - Min;
+	// ClampMin only applies in the details panel
+	const int32 BatchSize = FMath::Max(1, ProjectionBatchSize);
+	const int32 NumBatches = FMath::DivideAndRoundUp(Points.Num(), BatchSize);
+	TArray<FProjectionBatchStats> Batches;
+	Batches.SetNum(NumBatches);
 
-	float CX = FMath::FloorToInt(Local.X / CellSIze);
-	float CY = FMath::FloorToInt(Local.Y / CellSIze);
+	const double StartTime = FPlatformTime::Seconds();
 
-	if (!Grids.IsValidIndex(CX) ||
-		!Grids[CX].PointsIndex.IsValidIndex(CY))
+	std::atomic<int32> BatchesDone = 0;
+
+	ParallelFor(NumBatches, [&](int32 BatchIndex)
 	{
-		return false;
+		if (ShouldCancelGeneration())
+		{
+			return;
+		}
+
+		TRACE_CPUPROFILER_EVENT_SCOPE(UProceduralPlacementComponent::ProjectBatch);
+
+		FProjectionBatchStats& Stats = Batches[BatchIndex];
+		const double BatchStart = FPlatformTime::Seconds();
+
+		const int32 First = BatchIndex * BatchSize;
+		const int32 Last  = FMath::Min(First + BatchSize, Points.Num());
+
+		for (int32 i = First; i < Last; ++i)
+		{
+			const FVector2D PointXY(Points[i].X, Points[i].Y);
+			FVector Normal = FVector::UpVector;
+			bool bPlaced = false;
+
+			double Z;
+			if (bUseHeightfield && HeightSnapshot.SampleHeight(PointXY, Z))
+			{
+				Points[i].Z = Z;
+				if (bFilterSlope)
+				{
+					HeightSnapshot.SampleNormal(PointXY, Normal);
+				}
+				Stats.NumHeightfield++;
+				bPlaced = true;
+			}
+
+			if (!bPlaced)
+			{
+				FHitResult Hit;
+				const FVector Start(PointXY, HeightRange.Y);
+				const FVector End  (PointXY, HeightRange.X);
+
+				if (World->LineTraceSingleByChannel(
+					Hit, Start, End, ECC_WorldStatic, QueryParams))
+				{
+					Points[i] = Hit.Location;
+					Normal = Hit.ImpactNormal;
+				}
+				else
+				{
+					Stats.NumMisses++;
+				}
+			}
+
+			if (bFilterSlope && Normal.Z < MinNormalZ)
+			{
+				Rejected[i] = true;
+				Stats.NumRejected++;
+			}
+		}
+
+		Stats.NumPoints = Last - First;
+		Stats.Seconds = FPlatformTime::Seconds() - BatchStart;
+
+		SetGenerationProgress(FMath::Lerp(PlacementProgress::SamplingEnd, PlacementProgress::ProjectionEnd, float(++BatchesDone) / NumBatches));
+	});
+
+	int32 NumMisses = 0;
+	int32 NumHeightfield = 0;
+	int32 NumRejected = 0;
+	double SlowestBatch = 0.0;
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+	{
+		const FProjectionBatchStats& Stats = Batches[BatchIndex];
+		NumMisses += Stats.NumMisses;
+		NumHeightfield += Stats.NumHeightfield;
+		NumRejected += Stats.NumRejected;
+		SlowestBatch = FMath::Max(SlowestBatch, Stats.Seconds);
+
+		UE_LOG(LogProceduralPlacement, Verbose, TEXT("Projection batch %d: %d points, %d from heightfield, %d misses, %d too steep, %.2f ms"),
+			BatchIndex, Stats.NumPoints, Stats.NumHeightfield, Stats.NumMisses, Stats.NumRejected, Stats.Seconds * 1000.0);
 	}
 
-	for (int32 X = FMath::Max(0, CX - 2); X <= FMath::Min(CX + 2, Grids.Num() - 1); X++)
+	if (NumRejected > 0)
 	{
-		for (int32 Y = FMath::Max(0, CY - 2); Y <= FMath::Min(CY + 2, Grids[0].PointsIndex.Num() - 1); Y++)
+		int32 Write = 0;
+		for (int32 i = 0; i < Points.Num(); i++)
 		{
-			int32 Idx = Grids[X].PointsIndex[Y];
-			if (Idx != -1 &&
-				FVector::DistSquared(Points[Idx], Candidate) < Spacing * Spacing)
+			if (!Rejected[i])
 			{
-				return false;
+				Points[Write++] = Points[i];
 			}
 		}
+		Points.SetNum(Write, EAllowShrinking::No);
 	}
 
-	return true;
+	if (OutTotals)
+	{
+		OutTotals->NumPoints = Points.Num() + NumRejected;
+		OutTotals->NumMisses = NumMisses;
+		OutTotals->NumHeightfield = NumHeightfield;
+		OutTotals->NumRejected = NumRejected;
+		OutTotals->Seconds = FPlatformTime::Seconds() - StartTime;
+	}
+
+	UE_LOG(LogProceduralPlacement, Log, TEXT("%s: projected %d points in %d batches (%d from heightfield), %d misses, %d too steep, %.2f ms (slowest batch %.2f ms)"),
+		*GetNameSafe(GetOwner()), Points.Num() + NumRejected, NumBatches, NumHeightfield, NumMisses, NumRejected,
+		(FPlatformTime::Seconds() - StartTime) * 1000.0, SlowestBatch * 1000.0);
 }
 
-// Check if the point is in the spline area
-// Basic Raycasting algorithm
+// Vertical range the projection rays have to cover: the spline itself plus every
+// landscape component overlapping the zone, extended by ProjectionHeightMargin.
+// Never shorter than the fixed +/-5000 rays of earlier versions, which levels
+// with non-landscape ground far from the spline height rely on.
+// Game thread only, it walks the landscape actors of the world.
 
-void UProceduralPlacementComponent::CacheSpline()
+FVector2D UProceduralPlacementComponent::ComputeProjectionHeightRange() const
 {
-	SplinePoints.Empty();
+	FVector2D Range(SplineBounds.Min.Z, SplineBounds.Max.Z);
 
-	int32 N = Spline->GetNumberOfSplinePoints();
-	for (int i = 0; i < N; i++)
+	const FBox2D ZoneXY(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max));
+
+	for (TActorIterator<ALandscapeProxy> It(GetWorld()); It; ++It)
 	{
-		SplinePoints.Add(
-			Spline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World)
-		);
+		for (const ULandscapeComponent* LandscapeComponent : It->LandscapeComponents)
+		{
+			if (!LandscapeComponent)
+			{
+				continue;
+			}
+
+			const FBox Box = LandscapeComponent->Bounds.GetBox();
+			if (ZoneXY.Intersect(FBox2D(FVector2D(Box.Min), FVector2D(Box.Max))))
+			{
+				Range.X = FMath::Min(Range.X, Box.Min.Z);
+				Range.Y = FMath::Max(Range.Y, Box.Max.Z);
+			}
+		}
 	}
+
+	Range += FVector2D(-ProjectionHeightMargin, ProjectionHeightMargin);
+	Range.X = FMath::Min(Range.X, -PlacementProjection::MinTraceHalfHeight);
+	Range.Y = FMath::Max(Range.Y, PlacementProjection::MinTraceHalfHeight);
+	return Range;
 }
 
-bool UProceduralPlacementComponent::IsInside(FVector Candidate)
-{
-	int N = SplinePoints.Num();
-	bool Inside = false;
+// Checks whether a candidate point respects the minimum spacing constraint
+// by inspecting neighboring grid cells only (O(1) average complexity).
 
-	for (int i = 0; i < N; i++)
+bool UProceduralPlacementComponent::IsValid(const FVector& Candidate, const FPoissonSampleGrid& Grid, int32& OutCellX, int32& OutCellY) const
+{
+	if (!Grid.GetCell(Candidate, OutCellX, OutCellY))
 	{
-		FVector P1 = SplinePoints[i];
-		FVector P2 = SplinePoints[(i + 1) % N];
+		return false;
+	}
 
-		if (FMath::IsNearlyEqual(P1.Y, P2.Y))
-			continue;
+	return !Grid.HasNeighborWithin(Candidate, OutCellX, OutCellY, Spacing * Spacing);
+}
+
+// Check if the point is in the spline area
+// Basic Raycasting algorithm
+
+void UProceduralPlacementComponent::CacheSpline()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlacementCacheSpline);
+
+	GetSplinePolygon(Spline, SplinePoints);
 
-		bool yCheck = (P1.Y > Candidate.Y) != (P2.Y > Candidate.Y);
+	SplineBounds = FBox(SplinePoints);
 
-		double xIntersect =
-			(P2.X - P1.X) * (Candidate.Y - P1.Y)
-			/ (P2.Y - P1.Y)
-			+ P1.X;
+	// Shoelace formula
+	ZoneArea = 0.0;
+	for (int32 i = 0; i < SplinePoints.Num(); i++)
+	{
+		const FVector& P1 = SplinePoints[i];
+		const FVector& P2 = SplinePoints[(i + 1) % SplinePoints.Num()];
+		ZoneArea += P1.X * P2.Y - P2.X * P1.Y;
+	}
+	ZoneArea = FMath::Abs(ZoneArea) * 0.5;
+	PolygonIndex.Build(SplinePoints);
+	BuildExclusions();
+}
+
+void UProceduralPlacementComponent::GetSplinePolygon(USplineComponentPG* Source, TArray<FVector>& OutPoints) const
+{
+	OutPoints.Empty();
 
-		if (yCheck && Candidate.X < xIntersect)
+	if (TessellationTolerance > 0.0f)
+	{
+		Source->GetTessellatedPoints(TessellationTolerance, OutPoints);
+	}
+	else
+	{
+		int32 N = Source->GetNumberOfSplinePoints();
+		for (int i = 0; i < N; i++)
 		{
-			Inside = !Inside;
+			OutPoints.Add(
+				Source->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World)
+			);
 		}
 	}
-
-	return Inside;
 }
 
-// Get Max/Min points
+// Exclusion zones.
+// Hole outlines are read once per CacheSpline, then bucketed over the zone bounds so each
+// candidate only tests the holes near it. Zones with hundreds of holes sample about as
+// fast as zones without any.
 
-FVector UProceduralPlacementComponent::GetMinPoint()
+void UProceduralPlacementComponent::BuildExclusions()
 {
-	FVector MinPoint = SplinePoints[0];
-	
-	float CurrentX = SplinePoints[0].X;
-	float CurrentY = SplinePoints[0].Y;
-	
-	for (int i = 1; i < SplinePoints.Num(); ++i)
+	TArray<TArray<FVector>> HolePolygons;
+	for (USplineComponentPG* Exclusion : ExclusionSplines)
 	{
-		if (SplinePoints[i].X < CurrentX)
+		if (Exclusion && Exclusion != Spline && Exclusion->GetNumberOfSplinePoints() >= 3)
 		{
-			MinPoint.X = SplinePoints[i].X;
-			CurrentX = MinPoint.X;
+			GetSplinePolygon(Exclusion, HolePolygons.AddDefaulted_GetRef());
 		}
+	}
 
-		if (SplinePoints[i].Y < CurrentY)
+	TArray<FBox2D> HoleBoxes;
+	for (const AActor* Actor : ExclusionActors)
+	{
+		if (Actor && Actor != GetOwner())
 		{
-			MinPoint.Y = SplinePoints[i].Y;
-			CurrentY = MinPoint.Y;
+			const FBox Box = Actor->GetComponentsBoundingBox(true);
+			if (Box.IsValid)
+			{
+				HoleBoxes.Add(FBox2D(FVector2D(Box.Min), FVector2D(Box.Max)));
+			}
 		}
 	}
-	return MinPoint;
+
+	Exclusions.Build(FBox2D(FVector2D(SplineBounds.Min), FVector2D(SplineBounds.Max)), HolePolygons, HoleBoxes);
 }
 
-FVector UProceduralPlacementComponent::GetMaxPoint()
+bool UProceduralPlacementComponent::IsInside(FVector Candidate) const
 {
-	FVector MaxPoint = SplinePoints[0];
-	float CurrentX = SplinePoints[0].X;
-	float CurrentY = SplinePoints[0].Y;
-	
-	for (int i = 1; i < SplinePoints.Num(); ++i)
-	{
-		if (SplinePoints[i].X > CurrentX)
-		{
-			MaxPoint.X = SplinePoints[i].X;
-			CurrentX = MaxPoint.X;
-		}
+	const FVector2D Point(Candidate.X, Candidate.Y);
+	return PolygonIndex.IsInside(Point) && !Exclusions.IsExcluded(Point);
+}
+
+void UProceduralPlacementComponent::IsInsideBatch(TConstArrayView<FVector> Candidates, TBitArray<>& OutInside) const
+{
+	PolygonIndex.IsInsideBatch(Candidates, OutInside);
 
-		if (SplinePoints[i].Y > CurrentY)
+	if (!Exclusions.IsEmpty())
+	{
+		for (int32 Index = 0; Index < Candidates.Num(); Index++)
 		{
-			MaxPoint.Y = SplinePoints[i].Y;
-			CurrentY = MaxPoint.Y;
+			if (OutInside[Index] && Exclusions.IsExcluded(FVector2D(Candidates[Index])))
+			{
+				OutInside[Index] = false;
+			}
 		}
 	}
-	return MaxPoint;
+}
+
+// Get Max/Min points
+// Read from the bounds cached with the polygon, Z is the one of the first point
+
+FVector UProceduralPlacementComponent::GetMinPoint()
+{
+	return FVector(SplineBounds.Min.X, SplineBounds.Min.Y, SplinePoints[0].Z);
+}
+
+FVector UProceduralPlacementComponent::GetMaxPoint()
+{
+	return FVector(SplineBounds.Max.X, SplineBounds.Max.Y, SplinePoints[0].Z);
 }
@@ -1,6 +1,8 @@
 #include "ProceduralRuntimeModule.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogProceduralPlacement);
+
 class FProceduralRuntimeModule : public IModuleInterface
 {
 public:
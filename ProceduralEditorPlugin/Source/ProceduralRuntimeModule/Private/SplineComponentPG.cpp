@@ -3,3 +3,103 @@
 
 #include "SplineComponentPG.h"
 #include "Components/InstancedStaticMeshComponent.h"
+
+namespace SplineComponentPG
+{
+	// 2^10 sub-segments per spline segment at most
+	constexpr int32 MaxSubdivisionDepth = 10;
+}
+
+void USplineComponentPG::UpdateSpline()
+{
+	Super::UpdateSpline();
+	SplineRevision++;
+
+	OnSplineModified.Broadcast();
+}
+
+void USplineComponentPG::GetTessellatedPoints(float Tolerance, TArray<FVector>& OutPoints)
+{
+	if (TessellatedRevision != SplineRevision || TessellatedTolerance != Tolerance)
+	{
+		Tessellate(Tolerance);
+	}
+
+	const FTransform& Transform = GetComponentTransform();
+
+	OutPoints.Reset(TessellatedPoints.Num());
+	for (const FVector& Point : TessellatedPoints)
+	{
+		OutPoints.Add(Transform.TransformPosition(Point));
+	}
+}
+
+// Adaptive tessellation of every segment in local space.
+// Straight segments stay a single edge, curved ones are split until the curve
+// is within Tolerance of the polyline in the XY plane.
+
+void USplineComponentPG::Tessellate(float Tolerance)
+{
+	TessellatedPoints.Reset();
+	TessellatedTolerance = Tolerance;
+	TessellatedRevision = SplineRevision;
+
+	const int32 N = GetNumberOfSplinePoints();
+	if (N == 0)
+	{
+		return;
+	}
+
+	const int32 NumSegments = IsClosedLoop() ? N : N - 1;
+	for (int32 i = 0; i < NumSegments; i++)
+	{
+		const FVector A = GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local);
+		const FVector B = GetLocationAtSplinePoint((i + 1) % N, ESplineCoordinateSpace::Local);
+
+		TessellatedPoints.Add(A);
+		SubdivideSegment(i, i + 1, A, B, Tolerance, 0);
+	}
+
+	if (!IsClosedLoop())
+	{
+		TessellatedPoints.Add(GetLocationAtSplinePoint(N - 1, ESplineCoordinateSpace::Local));
+	}
+}
+
+// Emits the interior points of [KeyA, KeyB], A itself is already emitted.
+// The curve is checked at the quarter points as well as the midpoint so that
+// S-shaped segments whose midpoint lies on the chord still get split.
+
+void USplineComponentPG::SubdivideSegment(float KeyA, float KeyB, const FVector& A, const FVector& B, float Tolerance, int32 Depth)
+{
+	if (Depth >= SplineComponentPG::MaxSubdivisionDepth)
+	{
+		return;
+	}
+
+	const FVector FlatA(A.X, A.Y, 0.0);
+	const FVector FlatB(B.X, B.Y, 0.0);
+	auto DistanceToChord = [&FlatA, &FlatB](const FVector& Point)
+	{
+		return FMath::PointDistToSegment(FVector(Point.X, Point.Y, 0.0), FlatA, FlatB);
+	};
+
+	const float KeyMid = (KeyA + KeyB) * 0.5f;
+	const FVector Mid = GetLocationAtSplineInputKey(KeyMid, ESplineCoordinateSpace::Local);
+
+	bool bSplit = DistanceToChord(Mid) > Tolerance;
+	for (int32 Quarter = 1; !bSplit && Quarter <= 3; Quarter += 2)
+	{
+		const float Key = FMath::Lerp(KeyA, KeyB, Quarter * 0.25f);
+		bSplit = DistanceToChord(GetLocationAtSplineInputKey(Key, ESplineCoordinateSpace::Local)) > Tolerance;
+	}
+
+	if (!bSplit)
+	{
+		return;
+	}
+
+	SubdivideSegment(KeyA, KeyMid, A, Mid, Tolerance, Depth + 1);
+	TessellatedPoints.Add(Mid);
+	SubdivideSegment(KeyMid, KeyB, Mid, B, Tolerance, Depth + 1);
+}
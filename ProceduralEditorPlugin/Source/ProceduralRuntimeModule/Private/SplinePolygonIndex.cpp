@@ -0,0 +1,250 @@
+#include "SplinePolygonIndex.h"
+
+namespace SplinePolygonIndex
+{
+	constexpr int32 MaxSlabs = 4096;
+}
+
+void FSplinePolygonIndex::Reset()
+{
+	Edges.Reset();
+	Bounds = FBox2D(ForceInit);
+	NumSlabs = 0;
+	SlabHeight = 0.0;
+	SlabStart.Reset();
+	SlabEdges.Reset();
+	CellSize = 0.0;
+	Width = 0;
+	Height = 0;
+	Cells.Reset();
+}
+
+void FSplinePolygonIndex::Build(const TArray<FVector>& Polygon, int32 MaskResolution)
+{
+	Reset();
+
+	const int32 N = Polygon.Num();
+	if (N < 3)
+	{
+		return;
+	}
+
+	Edges.Reserve(N);
+	for (int32 i = 0; i < N; i++)
+	{
+		const FVector& P1 = Polygon[i];
+		const FVector& P2 = Polygon[(i + 1) % N];
+
+		Edges.Add({ FVector2D(P1.X, P1.Y), FVector2D(P2.X, P2.Y) });
+		Bounds += FVector2D(P1.X, P1.Y);
+	}
+
+	const FVector2D Extent = Bounds.GetSize();
+	if (Extent.X <= 0.0 || Extent.Y <= 0.0)
+	{
+		Reset();
+		return;
+	}
+
+	BuildSlabs();
+	BuildMask(FMath::Max(1, MaskResolution));
+}
+
+// Buckets the edges by the horizontal slabs their Y range overlaps.
+// Horizontal edges never toggle the ray test and are left out.
+
+void FSplinePolygonIndex::BuildSlabs()
+{
+	NumSlabs = FMath::Clamp(Edges.Num(), 1, SplinePolygonIndex::MaxSlabs);
+	SlabHeight = Bounds.GetSize().Y / NumSlabs;
+
+	TArray<int32> Counts;
+	Counts.Init(0, NumSlabs);
+
+	auto ForEachSlab = [this](const FEdge& Edge, auto&& Func)
+	{
+		if (FMath::IsNearlyEqual(Edge.P1.Y, Edge.P2.Y))
+		{
+			return;
+		}
+
+		const int32 First = GetSlab(FMath::Min(Edge.P1.Y, Edge.P2.Y));
+		const int32 Last  = GetSlab(FMath::Max(Edge.P1.Y, Edge.P2.Y));
+		for (int32 Slab = First; Slab <= Last; Slab++)
+		{
+			Func(Slab);
+		}
+	};
+
+	for (const FEdge& Edge : Edges)
+	{
+		ForEachSlab(Edge, [&Counts](int32 Slab) { Counts[Slab]++; });
+	}
+
+	SlabStart.SetNumUninitialized(NumSlabs + 1);
+	SlabStart[0] = 0;
+	for (int32 Slab = 0; Slab < NumSlabs; Slab++)
+	{
+		SlabStart[Slab + 1] = SlabStart[Slab] + Counts[Slab];
+		Counts[Slab] = SlabStart[Slab];
+	}
+
+	SlabEdges.SetNumUninitialized(SlabStart[NumSlabs]);
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); EdgeIndex++)
+	{
+		ForEachSlab(Edges[EdgeIndex], [&](int32 Slab) { SlabEdges[Counts[Slab]++] = EdgeIndex; });
+	}
+}
+
+// Rasterizes every edge into the mask, then resolves the remaining cells row by row.
+// A run of non-boundary cells in a row is not crossed by any edge, so one exact test
+// at the first cell of the run classifies the whole run.
+
+void FSplinePolygonIndex::BuildMask(int32 MaskResolution)
+{
+	const FVector2D Extent = Bounds.GetSize();
+	CellSize = FMath::Max(Extent.X, Extent.Y) / MaskResolution;
+	Width  = FMath::FloorToInt32(Extent.X / CellSize) + 1;
+	Height = FMath::FloorToInt32(Extent.Y / CellSize) + 1;
+
+	Cells.Init(ECellState::Outside, Width * Height);
+
+	for (const FEdge& Edge : Edges)
+	{
+		MarkEdgeCells(Edge);
+	}
+
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		ECellState* Row = Cells.GetData() + Y * Width;
+		bool bRunStarted = false;
+		ECellState RunState = ECellState::Outside;
+
+		for (int32 X = 0; X < Width; X++)
+		{
+			if (Row[X] == ECellState::Boundary)
+			{
+				bRunStarted = false;
+				continue;
+			}
+
+			if (!bRunStarted)
+			{
+				const FVector2D Center = Bounds.Min + FVector2D(X + 0.5, Y + 0.5) * CellSize;
+				RunState = IsInsideExact(Center) ? ECellState::Inside : ECellState::Outside;
+				bRunStarted = true;
+			}
+			Row[X] = RunState;
+		}
+	}
+}
+
+// Conservatively marks every cell the edge passes through, column by column.
+
+void FSplinePolygonIndex::MarkEdgeCells(const FEdge& Edge)
+{
+	const double Eps = CellSize * 1e-3;
+
+	const double EdgeMinX = FMath::Min(Edge.P1.X, Edge.P2.X);
+	const double EdgeMaxX = FMath::Max(Edge.P1.X, Edge.P2.X);
+	const double DX = Edge.P2.X - Edge.P1.X;
+	const double DY = Edge.P2.Y - Edge.P1.Y;
+
+	const int32 X0 = FMath::Clamp(FMath::FloorToInt32((EdgeMinX - Eps - Bounds.Min.X) / CellSize), 0, Width - 1);
+	const int32 X1 = FMath::Clamp(FMath::FloorToInt32((EdgeMaxX + Eps - Bounds.Min.X) / CellSize), 0, Width - 1);
+
+	for (int32 X = X0; X <= X1; X++)
+	{
+		const double ColumnMin = Bounds.Min.X + X * CellSize;
+		const double A = FMath::Clamp(ColumnMin, EdgeMinX, EdgeMaxX);
+		const double B = FMath::Clamp(ColumnMin + CellSize, EdgeMinX, EdgeMaxX);
+
+		double YA = Edge.P1.Y;
+		double YB = Edge.P2.Y;
+		if (FMath::Abs(DX) > UE_KINDA_SMALL_NUMBER)
+		{
+			YA = Edge.P1.Y + (A - Edge.P1.X) * DY / DX;
+			YB = Edge.P1.Y + (B - Edge.P1.X) * DY / DX;
+		}
+
+		const int32 Y0 = FMath::Clamp(FMath::FloorToInt32((FMath::Min(YA, YB) - Eps - Bounds.Min.Y) / CellSize), 0, Height - 1);
+		const int32 Y1 = FMath::Clamp(FMath::FloorToInt32((FMath::Max(YA, YB) + Eps - Bounds.Min.Y) / CellSize), 0, Height - 1);
+
+		for (int32 Y = Y0; Y <= Y1; Y++)
+		{
+			Cells[Y * Width + X] = ECellState::Boundary;
+		}
+	}
+}
+
+bool FSplinePolygonIndex::IsInside(const FVector2D& Point) const
+{
+	if (Cells.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 X = FMath::FloorToInt32((Point.X - Bounds.Min.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Point.Y - Bounds.Min.Y) / CellSize);
+	if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+	{
+		return false;
+	}
+
+	switch (Cells[Y * Width + X])
+	{
+	case ECellState::Inside:
+		return true;
+	case ECellState::Outside:
+		return false;
+	default:
+		return IsInsideExact(Point);
+	}
+}
+
+void FSplinePolygonIndex::IsInsideBatch(TConstArrayView<FVector> Candidates, TBitArray<>& OutInside) const
+{
+	OutInside.Init(false, Candidates.Num());
+
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		if (IsInside(FVector2D(Candidates[i].X, Candidates[i].Y)))
+		{
+			OutInside[i] = true;
+		}
+	}
+}
+
+// Basic Raycasting algorithm, only over the edges overlapping the slab of the point
+
+bool FSplinePolygonIndex::IsInsideExact(const FVector2D& Point) const
+{
+	if (NumSlabs == 0 || Point.Y < Bounds.Min.Y || Point.Y >= Bounds.Max.Y)
+	{
+		return false;
+	}
+
+	const int32 Slab = GetSlab(Point.Y);
+	bool Inside = false;
+
+	for (int32 i = SlabStart[Slab]; i < SlabStart[Slab + 1]; i++)
+	{
+		const FEdge& Edge = Edges[SlabEdges[i]];
+		const FVector2D& P1 = Edge.P1;
+		const FVector2D& P2 = Edge.P2;
+
+		bool yCheck = (P1.Y > Point.Y) != (P2.Y > Point.Y);
+
+		double xIntersect =
+			(P2.X - P1.X) * (Point.Y - P1.Y)
+			/ (P2.Y - P1.Y)
+			+ P1.X;
+
+		if (yCheck && Point.X < xIntersect)
+		{
+			Inside = !Inside;
+		}
+	}
+
+	return Inside;
+}
@@ -0,0 +1,182 @@
+#include "Misc/AutomationTest.h"
+#include "ProceduralPlacementComponent.h"
+#include "SplineComponentPG.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PoissonDiskSamplerTest
+{
+	// Concave zone with integer coordinates, so its bounds are exact in float and double
+	const TArray<FVector> ZonePoints =
+	{
+		FVector(0.0, 0.0, 0.0),
+		FVector(6000.0, 0.0, 0.0),
+		FVector(6000.0, 4000.0, 0.0),
+		FVector(3500.0, 4000.0, 0.0),
+		FVector(3000.0, 1500.0, 0.0),
+		FVector(2500.0, 4000.0, 0.0),
+		FVector(0.0, 4000.0, 0.0)
+	};
+
+	// The sampler as it was before the flat grid and the candidate batches: one column
+	// array per grid X, one candidate at a time, scalar sin/cos and 3D distances.
+	// Containment is asked to the component, only the sampling itself is the reference.
+	void SampleReference(const UProceduralPlacementComponent& Component, TArray<FVector>& Points)
+	{
+		const TArray<FVector>& SplinePoints = Component.SplinePoints;
+		const float Spacing = Component.Spacing;
+
+		FRandomStream Random(Component.Seed);
+
+		FVector Min = SplinePoints[0];
+		FVector Max = SplinePoints[0];
+		for (const FVector& Point : SplinePoints)
+		{
+			Min.X = FMath::Min(Min.X, Point.X);
+			Min.Y = FMath::Min(Min.Y, Point.Y);
+			Max.X = FMath::Max(Max.X, Point.X);
+			Max.Y = FMath::Max(Max.Y, Point.Y);
+		}
+
+		const float CellSize = Spacing / FMath::Sqrt(2.f);
+		const int32 GridWidth  = FMath::CeilToInt((Max.X - Min.X) / CellSize);
+		const int32 GridHeight = FMath::CeilToInt((Max.Y - Min.Y) / CellSize);
+
+		TArray<TArray<int32>> Columns;
+		Columns.SetNum(GridWidth);
+		for (TArray<int32>& Column : Columns)
+		{
+			Column.Init(INDEX_NONE, GridHeight);
+		}
+
+		auto IsValid = [&](const FVector& Candidate, int32& OutX, int32& OutY)
+		{
+			if (Candidate.X < Min.X || Candidate.X > Max.X ||
+				Candidate.Y < Min.Y || Candidate.Y > Max.Y)
+			{
+				return false;
+			}
+
+			OutX = FMath::FloorToInt((Candidate.X - Min.X) / CellSize);
+			OutY = FMath::FloorToInt((Candidate.Y - Min.Y) / CellSize);
+			if (!Columns.IsValidIndex(OutX) || !Columns[OutX].IsValidIndex(OutY))
+			{
+				return false;
+			}
+
+			for (int32 X = FMath::Max(0, OutX - 2); X <= FMath::Min(OutX + 2, GridWidth - 1); X++)
+			{
+				for (int32 Y = FMath::Max(0, OutY - 2); Y <= FMath::Min(OutY + 2, GridHeight - 1); Y++)
+				{
+					const int32 Idx = Columns[X][Y];
+					if (Idx != INDEX_NONE &&
+						FVector::DistSquared(Points[Idx], Candidate) < Spacing * Spacing)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+
+		TArray<FVector> ActivePoints;
+
+		FVector FirstPoint = SplinePoints[0];
+		FirstPoint.Z = 0.f;
+
+		ActivePoints.Add(FirstPoint);
+		Points.Add(FirstPoint);
+
+		while (ActivePoints.Num() > 0)
+		{
+			const int32 Index = Random.RandRange(0, ActivePoints.Num() - 1);
+			const FVector Current = ActivePoints[Index];
+			bool bFound = false;
+
+			for (int32 i = 0; i < 20; i++)
+			{
+				const float Angle = Random.FRandRange(0, TWO_PI);
+				const float Dist  = Random.FRandRange(Spacing, Spacing * 2);
+
+				const FVector Candidate =
+					Current +
+					FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Dist;
+
+				int32 CX, CY;
+				if (IsValid(Candidate, CX, CY) && Component.IsInside(Candidate))
+				{
+					Points.Add(Candidate);
+					ActivePoints.Add(Candidate);
+					Columns[CX][CY] = Points.Num() - 1;
+					bFound = true;
+					break;
+				}
+			}
+
+			if (!bFound)
+			{
+				ActivePoints.RemoveAt(Index);
+			}
+		}
+	}
+}
+
+// Bridson output must stay bit-identical for a given Seed/Spacing, whatever
+// acceleration structure or vectorization the sampler uses.
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoissonDiskBitIdentityTest, "ProceduralPlacement.Sampling.BridsonBitIdentity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPoissonDiskBitIdentityTest::RunTest(const FString& Parameters)
+{
+	using namespace PoissonDiskSamplerTest;
+
+	USplineComponentPG* Spline = NewObject<USplineComponentPG>(GetTransientPackage());
+	Spline->SetSplinePoints(ZonePoints, ESplineCoordinateSpace::World);
+	Spline->SetClosedLoop(true);
+
+	UProceduralPlacementComponent* Component = NewObject<UProceduralPlacementComponent>(GetTransientPackage());
+	Component->Spline = Spline;
+	Component->SamplingMode = EPlacementSamplingMode::Bridson;
+	Component->TessellationTolerance = 0.0f;
+	Component->CacheSpline();
+
+	const int32 Seeds[] = { 1, 123, 4242, 98765 };
+	const float Spacings[] = { 50.0f, 137.5f };
+
+	for (const float Spacing : Spacings)
+	{
+		for (const int32 Seed : Seeds)
+		{
+			Component->Seed = Seed;
+			Component->Spacing = Spacing;
+
+			TArray<FVector> Expected;
+			SampleReference(*Component, Expected);
+
+			TArray<FVector> Actual;
+			Component->PoissonDiskAlgo(Actual);
+
+			const FString Case = FString::Printf(TEXT("Seed %d, Spacing %.1f"), Seed, Spacing);
+			if (!TestEqual(*FString::Printf(TEXT("%s: point count"), *Case), Actual.Num(), Expected.Num()))
+			{
+				continue;
+			}
+
+			for (int32 i = 0; i < Expected.Num(); i++)
+			{
+				if (Actual[i].X != Expected[i].X || Actual[i].Y != Expected[i].Y || Actual[i].Z != Expected[i].Z)
+				{
+					AddError(FString::Printf(TEXT("%s: point %d is %s, expected %s"),
+						*Case, i, *Actual[i].ToString(), *Expected[i].ToString()));
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BlueNoiseTileSet.generated.h"
+
+USTRUCT()
+struct PROCEDURALRUNTIMEMODULE_API FBlueNoiseTile
+{
+	GENERATED_BODY()
+
+	// In spacing units, within [0, TileSize)
+	UPROPERTY()
+	TArray<FVector2f> Points;
+};
+
+// Precomputed Poisson disk tiles that can be laid next to each other in any combination.
+// Points are stored for a spacing of 1 and scaled by the zone Spacing when stamped,
+// so one tile set serves every spacing.
+// All tiles share the border band (points closer than one spacing to an edge) of a
+// single toroidal tile and only differ inside, which keeps the minimum distance across
+// every tile edge whichever tiles end up side by side.
+
+UCLASS(BlueprintType)
+class PROCEDURALRUNTIMEMODULE_API UBlueNoiseTileSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Number of tile variants to pick from, more variants hide repetition better
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Blue Noise", meta=(ClampMin="1", ClampMax="256"))
+	int32 NumTiles = 16;
+
+	// Side of a tile in spacing units, the varying interior is TileSize - 2 wide
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Blue Noise", meta=(ClampMin="4.0", ClampMax="64.0"))
+	float TileSize = 16.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Blue Noise")
+	int32 GeneratorSeed = 0;
+
+	UPROPERTY(VisibleAnywhere, Category="Blue Noise")
+	TArray<FBlueNoiseTile> Tiles;
+
+	// Regenerates Tiles from the settings above
+	UFUNCTION(CallInEditor, Category="Blue Noise")
+	void Build();
+
+	static void BuildTiles(int32 InNumTiles, float InTileSize, int32 InSeed, TArray<FBlueNoiseTile>& OutTiles);
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
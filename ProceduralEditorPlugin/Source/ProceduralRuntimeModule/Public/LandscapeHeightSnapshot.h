@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// One-time copy of the landscape heights under a zone, stored as a regular grid.
+// Sampling is a bilinear lookup, so projecting a point no longer needs a physics query.
+// Heights come from the landscape collision data, which is also available with -nullrhi.
+
+struct PROCEDURALRUNTIMEMODULE_API FLandscapeHeightSnapshot
+{
+	// Samples every landscape overlapping Bounds, returns false when none was found
+	bool Build(UWorld* World, const FBox2D& Bounds);
+	void Reset();
+
+	bool IsEmpty() const { return Heights.Num() == 0; }
+
+	// False when one of the four surrounding samples is not over a landscape
+	bool SampleHeight(const FVector2D& Point, double& OutZ) const;
+
+	// Surface normal from the gradient of the cell containing the point
+	bool SampleNormal(const FVector2D& Point, FVector& OutNormal) const;
+
+	FVector2D Origin = FVector2D::ZeroVector;
+	double CellSize = 0.0;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// Row-major, NaN where there is no landscape
+	TArray<float> Heights;
+
+private:
+	bool GetCorners(const FVector2D& Point, float OutCorners[4], double& OutAlphaX, double& OutAlphaY) const;
+};
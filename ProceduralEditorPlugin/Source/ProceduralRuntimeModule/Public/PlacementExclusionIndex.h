@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SplinePolygonIndex.h"
+
+// Holes cut out of a zone, closed polygons or axis aligned boxes.
+// Hole bounds are bucketed into a uniform grid over the zone, so a point only runs the
+// tests of the few holes overlapping its bucket, whatever the number of holes. Polygons
+// keep their own containment index with a coarser mask than the zone.
+
+struct PROCEDURALRUNTIMEMODULE_API FPlacementExclusionIndex
+{
+	// Holes not overlapping Bounds are dropped
+	void Build(const FBox2D& Bounds, TConstArrayView<TArray<FVector>> InPolygons, TConstArrayView<FBox2D> Boxes);
+	void Reset();
+
+	bool IsEmpty() const { return Holes.Num() == 0; }
+	int32 Num() const { return Holes.Num(); }
+
+	bool IsExcluded(const FVector2D& Point) const;
+
+	// Hash of the holes whose bounds overlap Box, 0 when there is none
+	uint32 GetOverlapHash(const FBox2D& Box) const;
+
+	// Polygon vertices of every hole, boxes as their four corners
+	TConstArrayView<FVector2D> GetVertices() const { return Vertices; }
+
+private:
+	struct FHole
+	{
+		FBox2D Bounds = FBox2D(ForceInit);
+		int32 FirstVertex = 0;
+		int32 NumVertices = 0;
+		// INDEX_NONE for a box, whose bounds are the hole
+		int32 Polygon = INDEX_NONE;
+		uint32 Hash = 0;
+	};
+
+	FORCEINLINE int32 GetCellCoord(double Value, double Origin, int32 Size) const
+	{
+		return FMath::Clamp(FMath::FloorToInt32((Value - Origin) / CellSize), 0, Size - 1);
+	}
+
+	TArray<FHole> Holes;
+	TArray<FVector2D> Vertices;
+	TArray<FSplinePolygonIndex> Polygons;
+
+	// Hole lists per bucket, stored as offsets into CellHoles
+	FBox2D GridBounds = FBox2D(ForceInit);
+	double CellSize = 0.0;
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<int32> CellStart;
+	TArray<int32> CellHoles;
+};
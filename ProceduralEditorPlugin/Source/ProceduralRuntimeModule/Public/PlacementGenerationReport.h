@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlacementGenerationReport.generated.h"
+
+// Sampler counters, kept per thread and merged once sampling is done
+struct FPlacementSamplingStats
+{
+	int64 NumCandidates = 0;
+	int64 NumSpacingRejections = 0;
+	int64 NumOutsideRejections = 0;
+	int64 NumLayerRejections = 0;
+	int32 PeakActivePoints = 0;
+
+	void Merge(const FPlacementSamplingStats& Other)
+	{
+		NumCandidates += Other.NumCandidates;
+		NumSpacingRejections += Other.NumSpacingRejections;
+		NumOutsideRejections += Other.NumOutsideRejections;
+		NumLayerRejections += Other.NumLayerRejections;
+		PeakActivePoints = FMath::Max(PeakActivePoints, Other.PeakActivePoints);
+	}
+};
+
+// What the last generation of a zone did and how long each stage took
+USTRUCT(BlueprintType)
+struct PROCEDURALRUNTIMEMODULE_API FPlacementGenerationReport
+{
+	GENERATED_BODY()
+
+	// Points were loaded from the point cache, sampling and projection did not run
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	bool bFromPointCache = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumPolygonVertices = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumSampledPoints = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int64 NumCandidates = 0;
+
+	// Candidates rejected by IsValid, closer than Spacing to an accepted point
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int64 NumSpacingRejections = 0;
+
+	// Candidates outside the zone, or outside their tile in tiled mode
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int64 NumOutsideRejections = 0;
+
+	// Candidates too close to a point of a lower layer of the group
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int64 NumLayerRejections = 0;
+
+	// Largest active list, per tile in tiled mode
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 PeakActivePoints = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumTraceHits = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumTraceMisses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumHeightfieldHits = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumSlopeRejections = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	int32 NumInstances = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	float CacheSplineMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	float SamplingMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	float ProjectionMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	float SubmitMs = 0.0f;
+
+	// Wall time from the start of the generation to the last instance, includes waiting for the game thread
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Stats")
+	float TotalMs = 0.0f;
+
+	void SetSamplingStats(const FPlacementSamplingStats& Stats);
+
+	FString ToString() const;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class UInstancedStaticMeshComponent;
+
+DECLARE_DELEGATE(FOnPlacementBuilderDone);
+
+// Adds a large batch of instances over several frames.
+// Every core ticker tick adds chunks of ChunkSize instances until BudgetMs is spent,
+// so the game thread never stalls on one huge AddInstances call. Instances keep the
+// order of the transforms they were given. Several components are filled one after the other.
+
+class PROCEDURALRUNTIMEMODULE_API FPlacementInstanceBuilder : public TSharedFromThis<FPlacementInstanceBuilder>
+{
+public:
+	FPlacementInstanceBuilder(UInstancedStaticMeshComponent* InComponent, TArray<FTransform>&& InTransforms, float InBudgetMs, int32 InChunkSize);
+	FPlacementInstanceBuilder(TConstArrayView<UInstancedStaticMeshComponent*> InComponents, TArray<TArray<FTransform>>&& InTransforms, float InBudgetMs, int32 InChunkSize);
+	~FPlacementInstanceBuilder();
+
+	// Registers with the core ticker, the first chunks go in on the next tick
+	void Start();
+
+	// Stops adding instances, the ones already added stay
+	void Cancel();
+
+	bool IsDone() const { return NumAdded == NumTotal; }
+
+	float GetProgress() const { return NumTotal > 0 ? float(NumAdded) / NumTotal : 1.0f; }
+
+	// Called once the last instance has been added, not on Cancel
+	FOnPlacementBuilderDone OnBuilt;
+
+private:
+	bool Tick(float DeltaTime);
+
+	struct FTarget
+	{
+		TWeakObjectPtr<UInstancedStaticMeshComponent> Component;
+		TArray<FTransform> Transforms;
+		int32 NumAdded = 0;
+	};
+
+	TArray<FTarget> Targets;
+	int32 CurrentTarget = 0;
+	int32 NumAdded = 0;
+	int32 NumTotal = 0;
+
+	float BudgetMs = 0.0f;
+	int32 ChunkSize = 0;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Points already placed by the earlier zones of a layer group, each with the footprint
+// radius of its zone. A candidate of a later layer is blocked when it is closer to one of
+// them than the two radii added up. Cells are twice the largest radius wide, so a query
+// scans the same 3x3 neighborhood as the sampling grid.
+
+struct PROCEDURALRUNTIMEMODULE_API FPlacementLayerIndex
+{
+	// MaxRadius has to cover the radius of every layer added or queried
+	void Init(const FBox2D& InBounds, float InMaxRadius);
+	void Reset();
+
+	bool IsEmpty() const { return Points.Num() == 0; }
+	int32 Num() const { return Points.Num(); }
+
+	// Points that cannot reach the bounds are skipped
+	void Add(TConstArrayView<FVector> InPoints, float Radius);
+
+	// True if a registered point is closer than Radius plus its own radius
+	bool IsBlocked(const FVector2D& Candidate, float Radius) const;
+
+	TConstArrayView<FVector2D> GetPoints() const { return Points; }
+	TConstArrayView<float> GetRadii() const { return Radii; }
+
+private:
+	FORCEINLINE int32 GetCellCoord(double Value, double Origin, int32 Size) const
+	{
+		return FMath::Clamp(FMath::FloorToInt32((Value - Origin) / CellSize), 0, Size - 1);
+	}
+
+	FBox2D Bounds = FBox2D(ForceInit);
+	double CellSize = 0.0;
+	float MaxRadius = 0.0f;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// First point of each cell and next point of the same cell, INDEX_NONE terminated
+	TArray<int32> Heads;
+	TArray<int32> Next;
+
+	TArray<FVector2D> Points;
+	TArray<float> Radii;
+};
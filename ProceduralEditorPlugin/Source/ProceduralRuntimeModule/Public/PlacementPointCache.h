@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Projected point sets stored on disk, one compressed file per cache key.
+// The key is a hash of every input the points depend on (see UProceduralPlacementComponent::GetPointCacheKey),
+// so a file never needs to be invalidated, only a key that no longer matches is left unused.
+// Files live in Saved/ProceduralPlacementCache and can be deleted at any time.
+
+struct PROCEDURALRUNTIMEMODULE_API FPlacementPointCache
+{
+	static FString GetDirectory();
+
+	// False when there is no file for Key or it cannot be read
+	static bool Load(const FString& Key, TArray<FVector>& OutPoints);
+
+	// Safe to call from worker threads, a concurrent writer of the same key writes the same bytes
+	static bool Save(const FString& Key, TConstArrayView<FVector> Points);
+
+	// Deletes every cached point set
+	static void Clear();
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlacementPointStorage.generated.h"
+
+// Quantized copy of a point array, used to save Positions instead of full precision vectors.
+// Points are stored in chunks of consecutive points, which keeps the order (instance i is
+// still point i) and lets chunks decode in parallel. In a chunk, X and Y are 16 bit offsets
+// within the chunk bounds, Z is quantized to Spacing / 1024 and delta coded as varints.
+// A chunk of ChunkSize points costs about 5 bytes per point before compression, against 24.
+// A chunk spread too wide for 16 bit steps of at most Spacing / 64 is cell coded: each point
+// keeps 16 bit XY within a cell of 65536 such steps, plus the varint delta of its cell.
+
+USTRUCT()
+struct PROCEDURALRUNTIMEMODULE_API FPlacementPointStorage
+{
+	GENERATED_BODY()
+
+	static constexpr int32 ChunkSize = 4096;
+
+	// Replaces the stored points, bCompress also runs each chunk through Oodle
+	void Encode(TConstArrayView<FVector> Points, float Spacing, bool bCompress = true);
+
+	// OutPoints is resized to the stored count, left empty when the data is corrupted
+	void Decode(TArray<FVector>& OutPoints) const;
+
+	void Reset();
+
+	int32 Num() const { return NumPoints; }
+	SIZE_T GetAllocatedSize() const;
+
+	bool Serialize(FArchive& Ar);
+
+	// Only empty storages compare equal, so stored points are never skipped as unchanged defaults
+	bool Identical(const FPlacementPointStorage* Other, uint32 PortFlags) const;
+
+private:
+	struct FChunk
+	{
+		FVector Min = FVector::ZeroVector;
+		FVector2D Step = FVector2D::ZeroVector;
+		int32 NumPoints = 0;
+
+		// XY stored as doubles instead of 16 bit offsets, only read from version 2 data
+		bool bFullPrecision = false;
+
+		// Step is the coarsest allowed, every point adds its cell to its 16 bit offsets
+		bool bCellCoded = false;
+
+		// Size of Data before compression, 0 when Data is not compressed
+		int32 RawSize = 0;
+		TArray<uint8> Data;
+	};
+
+	static void SerializeChunk(FArchive& Ar, FChunk& Chunk, int32 Version);
+
+	// Chunks whose 16 bit XY step would exceed MaxStep are cell coded
+	static void EncodeChunk(TConstArrayView<FVector> Points, double HeightStep, double MaxStep, bool bCompress, FChunk& OutChunk);
+	static bool DecodeChunk(const FChunk& Chunk, double HeightStep, FVector* OutPoints);
+
+	int32 NumPoints = 0;
+	double HeightStep = 1.0;
+	TArray<FChunk> Chunks;
+};
+
+template<>
+struct TStructOpsTypeTraits<FPlacementPointStorage> : public TStructOpsTypeTraitsBase2<FPlacementPointStorage>
+{
+	enum
+	{
+		WithSerializer = true,
+		WithIdentical = true
+	};
+};
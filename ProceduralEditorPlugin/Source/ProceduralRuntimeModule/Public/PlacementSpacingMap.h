@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Local Poisson radius over a zone, stored as a regular grid of cell-center values.
+// Filled once on the game thread from the density source, then only read by the sampler,
+// so sampling never touches textures, curves or the polygon edges.
+
+struct PROCEDURALRUNTIMEMODULE_API FPlacementSpacingMap
+{
+	void Init(const FBox2D& Bounds, double InCellSize);
+	void Reset();
+
+	bool IsEmpty() const { return Spacings.Num() == 0; }
+
+	FVector2D GetCellCenter(int32 X, int32 Y) const
+	{
+		return Origin + FVector2D(X + 0.5, Y + 0.5) * CellSize;
+	}
+
+	// Bilinear between cell centers, clamped to the border cells
+	float GetSpacing(const FVector2D& Point) const;
+
+	// Smallest and largest values of Spacings, set by UpdateRange
+	void UpdateRange();
+
+	FVector2D Origin = FVector2D::ZeroVector;
+	double CellSize = 0.0;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// Row-major
+	TArray<float> Spacings;
+
+	float MinSpacing = 0.0f;
+	float MaxSpacing = 0.0f;
+};
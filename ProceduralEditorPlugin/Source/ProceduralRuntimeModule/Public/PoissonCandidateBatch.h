@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPoissonSampleGrid;
+
+// The 20 annulus candidates the Bridson sampler tries around one active point,
+// stored as separate X and Y lanes so spacing checks run four candidates at a time.
+// Draws follow the scalar loop (angle then distance, candidate after candidate) and
+// the stream state after each candidate is kept, so the caller can rewind the stream
+// to where the scalar loop would have stopped. Only the spacing checks are vectorized,
+// positions are computed exactly as the scalar loop does.
+
+struct PROCEDURALRUNTIMEMODULE_API FPoissonCandidateBatch
+{
+	static constexpr int32 Num = 20;
+
+	// Draws every candidate from Random and advances it past all of them
+	void Generate(const FVector& InCenter, float Spacing, FRandomStream& Random);
+
+	// Bit i is set when candidate i has a grid point closer than sqrt(RadiusSquared).
+	// Same answers as FPoissonSampleGrid::HasNeighborWithin, with Spacing as the radius.
+	uint32 FindCrowded(const FPoissonSampleGrid& Grid, float RadiusSquared) const;
+
+	FORCEINLINE FVector GetCandidate(int32 Index) const
+	{
+		return FVector(X[Index], Y[Index], Center.Z);
+	}
+
+	FVector Center = FVector::ZeroVector;
+
+	alignas(32) double X[Num];
+	alignas(32) double Y[Num];
+
+	// Stream state right after candidate i was drawn
+	FRandomStream StreamAfter[Num];
+};
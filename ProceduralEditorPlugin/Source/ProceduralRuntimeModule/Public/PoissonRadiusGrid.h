@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Background grid for variable-radius Poisson sampling.
+// Levels double their cell size from the smallest radius up to the largest one, and every
+// point is linked into one cell of each level. A query for radius R scans the 3x3 cells of
+// the first level whose cells are at least R wide, so its cost stays the same whatever the
+// ratio between the smallest and the largest radius.
+
+struct PROCEDURALRUNTIMEMODULE_API FPoissonRadiusGrid
+{
+	void Init(const FVector2D& InMin, const FVector2D& InMax, float MinRadius, float MaxRadius);
+
+	bool IsInBounds(const FVector2D& Point) const;
+
+	// True if a registered point is closer than Radius to Candidate
+	bool HasNeighborWithin(const FVector2D& Candidate, float Radius) const;
+
+	// Expects a point within bounds
+	void Add(const FVector2D& Point);
+
+	int32 Num() const { return Points.Num(); }
+
+private:
+	struct FLevel
+	{
+		double CellSize = 0.0;
+		int32 Width = 0;
+		int32 Height = 0;
+
+		// First point of each cell and next point of the same cell, INDEX_NONE terminated
+		TArray<int32> Heads;
+		TArray<int32> Next;
+	};
+
+	FORCEINLINE int32 GetCellCoord(double Value, double LevelMin, double CellSize, int32 Size) const
+	{
+		return FMath::Clamp(FMath::FloorToInt32((Value - LevelMin) / CellSize), 0, Size - 1);
+	}
+
+	FVector2D Min = FVector2D::ZeroVector;
+	FVector2D Max = FVector2D::ZeroVector;
+
+	TArray<FLevel> Levels;
+	TArray<FVector2D> Points;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Background acceleration grid for the Poisson disk sampler.
+// Cells are stored row-major in one contiguous index buffer (INDEX_NONE when empty)
+// and the accepted points are packed as XY right next to it, so a neighbor query
+// only reads the 5x5 cells around a candidate.
+
+struct PROCEDURALRUNTIMEMODULE_API FPoissonSampleGrid
+{
+	void Init(const FVector& InMin, const FVector& InMax, float InCellSize);
+
+	// Grid with an explicit cell count, used when cells must line up with sampling tiles.
+	// Points then get one slot per cell so disjoint regions can be filled concurrently.
+	void InitSlotted(const FVector2D& InMin, float InCellSize, int32 InWidth, int32 InHeight);
+
+	// Returns false when the point falls outside the sampling bounds or the grid
+	bool GetCell(const FVector& Point, int32& OutX, int32& OutY) const;
+
+	// Registers a new point in the given cell and returns its index in Points
+	int32 Add(const FVector& Point, int32 CellX, int32 CellY);
+
+	// Stores the point in the slot owned by its cell (grids built with InitSlotted only)
+	int32 AddToSlot(const FVector& Point, int32 CellX, int32 CellY);
+
+	// True if a registered point in the 5x5 neighborhood is closer than sqrt(RadiusSquared)
+	bool HasNeighborWithin(const FVector& Candidate, int32 CellX, int32 CellY, float RadiusSquared) const;
+
+	FORCEINLINE int32 GetCellIndex(int32 CellX, int32 CellY) const
+	{
+		return CellY * Width + CellX;
+	}
+
+	FVector2D Min = FVector2D::ZeroVector;
+	FVector2D Max = FVector2D::ZeroVector;
+	float CellSize = 0.0f;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	TArray<int32> Cells;
+	TArray<FVector2D> Points;
+};
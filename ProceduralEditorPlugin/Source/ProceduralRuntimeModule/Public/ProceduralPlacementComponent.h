@@ -4,22 +4,124 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Async/Future.h"
 #include "Landscape.h"
 #include "SplineComponentPG.h"
 #include "SceneInterface.h"
 #include "LandscapeComponent.h"
 #include "EngineUtils.h"
+#include "PoissonSampleGrid.h"
+#include "SplinePolygonIndex.h"
+#include "LandscapeHeightSnapshot.h"
+#include "PlacementGenerationReport.h"
+#include "BlueNoiseTileSet.h"
+#include "PlacementInstanceBuilder.h"
+#include "PlacementPointStorage.h"
+#include "PlacementSpacingMap.h"
+#include "PlacementLayerIndex.h"
+#include "PlacementExclusionIndex.h"
+#include "Curves/CurveFloat.h"
+#include <atomic>
 #include "ProceduralPlacementComponent.generated.h"
 
+class UTexture2D;
+class FBlake3;
+
+UENUM(BlueprintType)
+enum class EPlacementSamplingMode : uint8
+{
+	// Single Bridson pass grown from the first spline point
+	Bridson,
+	// Zone split into tiles, non-adjacent tiles are sampled in parallel
+	TiledBridson,
+	// Precomputed tiles stamped over the zone, no neighbor search at all
+	BlueNoiseTiles
+};
+
+UENUM(BlueprintType)
+enum class EPlacementProjectionMode : uint8
+{
+	// One line trace per point against world static geometry
+	LineTrace,
+	// Bilinear lookup in a snapshot of the landscape heights, traces only off the landscape
+	LandscapeHeightfield
+};
+
+UENUM(BlueprintType)
+enum class EPlacementDensitySource : uint8
+{
+	// Spacing everywhere
+	None,
+	// Grey level of DensityTexture stretched over the zone bounds
+	Texture,
+	// Distance (cm) to the closest edge of the zone
+	EdgeDistance,
+	// Landscape slope in degrees
+	Slope
+};
+
+struct FProjectionBatchStats
+{
+	int32 NumPoints = 0;
+	int32 NumMisses = 0;
+	int32 NumHeightfield = 0;
+	int32 NumRejected = 0;
+	double Seconds = 0.0;
+};
+
+// Points of one sampling tile and the ISM instances created for them
+struct FPlacementTile
+{
+	// Hash of the inputs the tile was sampled from
+	uint32 InputHash = 0;
+
+	// Projected points, InstanceIndices[i] is the instance of Points[i]
+	TArray<FVector> Points;
+	TArray<int32> InstanceIndices;
+};
+
+USTRUCT(BlueprintType)
+struct FPlacementMeshEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
+	TObjectPtr<UStaticMesh> Mesh;
+
+	// Relative chance of a point getting this mesh
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement", meta=(ClampMin="0.0"))
+	float Weight = 1.0f;
+};
+
+// Instance components of a streamed tile, one per mesh that got points
 USTRUCT()
-struct FGridCell
+struct FPlacementStreamedTile
 {
 	GENERATED_BODY()
 
-	UPROPERTY()
-	TArray<float> PointsIndex;
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> Components;
 };
 
+// Tile being sampled and projected on a worker thread for runtime streaming
+struct FPlacementStreamingRequest
+{
+	FIntPoint Tile;
+	TFuture<TArray<FVector>> Future;
+};
+
+// Cancellation flag and progress shared between a running generation and the game thread
+struct FPlacementGenerationTask
+{
+	std::atomic<bool> bCancelled { false };
+	std::atomic<float> Progress { 0.0f };
+	TFuture<void> Future;
+	// Live preview sampling, its points never reach the ISMs
+	bool bPreview = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPlacementInstancesBuilt);
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class PROCEDURALRUNTIMEMODULE_API UProceduralPlacementComponent : public UActorComponent
 {
@@ -31,27 +133,233 @@ public:
 
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void BeginDestroy() override;
+	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+	virtual void Serialize(FArchive& Ar) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PreEditUndo() override;
+	virtual void PostEditUndo() override;
+#endif
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
 	TObjectPtr<UStaticMesh> Mesh;
 	
+	// Meshes mixed in the zone, used instead of Mesh when not empty.
+	// Each point picks one entry by weight, from Seed and its index, and every entry gets its own ISM.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
+	TArray<FPlacementMeshEntry> MeshPalette;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
     TObjectPtr<USplineComponentPG> Spline;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
 	int32 Seed = 123;
 
-	UPROPERTY()
+	// Closed splines cut out of the zone, such as roads, rivers or building footprints
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Exclusion")
+	TArray<TObjectPtr<USplineComponentPG>> ExclusionSplines;
+
+	// Actors whose bounds are cut out of the zone, as axis aligned boxes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Exclusion")
+	TArray<TObjectPtr<AActor>> ExclusionActors;
+
+	// Left out of transactions, undo rebuilds the instances from GeneratedPointsKey
+	UPROPERTY(NonTransactional)
 	TArray<FVector> Positions;
 
+	// Inputs hash of the instanced points, empty when the zone is cleared.
+	// This is all a generation transaction records of the result.
+	UPROPERTY()
+	FString GeneratedPointsKey;
+
+	// Save Positions quantized (see FPlacementPointStorage) and rebuild the instances on load,
+	// instead of saving both at full precision. Loaded positions are within Spacing / 64 in XY.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances")
+	bool bCompactStorage = true;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
 	float Spacing = 0.0f;
 
-	UPROPERTY()
+	// Sample and project on worker threads, only instance submission blocks the game thread
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
+	bool bAsyncGeneration = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
+	EPlacementSamplingMode SamplingMode = EPlacementSamplingMode::Bridson;
+
+	// World size of a sampling tile, rounded to a whole number of grid cells
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement", meta=(ClampMin="1.0", EditCondition="SamplingMode==EPlacementSamplingMode::TiledBridson"))
+	float SamplingTileSize = 5000.0f;
+
+	// Tiles stamped in BlueNoiseTiles mode, a default set is built in memory when empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement", meta=(EditCondition="SamplingMode==EPlacementSamplingMode::BlueNoiseTiles"))
+	TObjectPtr<UBlueNoiseTileSet> BlueNoiseTileSet;
+
+	// Max distance (cm) between the spline curve and the polygon used for containment.
+	// 0 treats the zone as the straight-edged polygon of the control points.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement", meta=(ClampMin="0.0"))
+	float TessellationTolerance = 10.0f;
+
+	// Varies the spacing between Spacing (density 1) and MaxSpacing (density 0) over the zone.
+	// Sampled with the serial Bridson sampler whatever SamplingMode is.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Density")
+	EPlacementDensitySource DensitySource = EPlacementDensitySource::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Density", meta=(ClampMin="0.0", EditCondition="DensitySource!=EPlacementDensitySource::None"))
+	float MaxSpacing = 1000.0f;
+
+	// Needs G8 or BGRA8 data, uncompressed in cooked builds
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Density", meta=(EditCondition="DensitySource==EPlacementDensitySource::Texture"))
+	TObjectPtr<UTexture2D> DensityTexture;
+
+	// Density from 0 to 1 for a value of the source. Without keys, texture values are
+	// used as they are and the other sources keep full density.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Density", meta=(EditCondition="DensitySource!=EPlacementDensitySource::None"))
+	FRuntimeFloatCurve DensityCurve;
+
+	// Zones of the same group in the world are placed in LayerOrder, and the points of
+	// lower orders are obstacles for higher ones. None keeps the zone independent.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Layers")
+	FName LayerGroup;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Layers")
+	int32 LayerOrder = 0;
+
+	// Footprint of one instance, points of two layers stay at least their radii added up apart
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Layers", meta=(ClampMin="0.0"))
+	float LayerRadius = 50.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Projection")
+	EPlacementProjectionMode ProjectionMode = EPlacementProjectionMode::LineTrace;
+
+	// Points projected on steeper ground are dropped, 90 keeps everything
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Projection", meta=(ClampMin="0.0", ClampMax="90.0"))
+	float MaxSlopeAngle = 90.0f;
+
+	// Added above and below the zone height range when tracing down to the ground.
+	// Rays always span at least Z -5000 to 5000.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Projection", meta=(ClampMin="0.0"))
+	float ProjectionHeightMargin = 500.0f;
+
+	// Number of traces per projection task
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Projection", meta=(ClampMin="1"))
+	int32 ProjectionBatchSize = 1024;
+
+	// Orders Positions so that every prefix is itself an evenly spread, coarser Poisson set.
+	// Lets density scaling drop the tail instead of resampling, but disables tile patching.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement")
+	bool bProgressiveOrder = false;
+
+	// Spline edits only resample the tiles they touch, once they stop for PreviewDelay.
+	// Needs tiled sampling and a first Generate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Placement", meta=(EditCondition="SamplingMode==EPlacementSamplingMode::TiledBridson"))
+	bool bRegenerateOnSplineEdit = false;
+
+	// Add instances over several frames instead of in one call.
+	// Instances rebuilt when a compact zone is loaded always go in at once.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances")
+	bool bTimeSliceInstances = false;
+
+	// Game thread time spent adding instances per frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances", meta=(ClampMin="0.1", EditCondition="bTimeSliceInstances"))
+	float InstanceBudgetMs = 4.0f;
+
+	// Instances added per AddInstances call
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances", meta=(ClampMin="1", EditCondition="bTimeSliceInstances"))
+	int32 InstanceChunkSize = 4096;
+
+	// Orders instances by distance to the camera, so the visible area fills in first.
+	// Only the build order changes, but spline edits then regenerate the whole zone.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances", meta=(EditCondition="bTimeSliceInstances"))
+	bool bBuildNearestFirst = false;
+
+	// Share of the points turned into instances, multiplied by placement.DensityScale.
+	// Only progressive zones are scaled, their kept instances still cover the whole zone.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Instances", meta=(ClampMin="0.0", ClampMax="1.0", EditCondition="bProgressiveOrder"))
+	float DensityScale = 1.0f;
+
+	// Broadcast once every instance of a generation is in the ISM
+	UPROPERTY(BlueprintAssignable, Category="Instances")
+	FOnPlacementInstancesBuilt OnInstancesBuilt;
+
+	// Seconds without edits before the live preview resamples or spline edits patch the tiles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Preview", meta=(ClampMin="0.0"))
+	float PreviewDelay = 0.25f;
+
+	// Preview instances shown at most, taken evenly over the sampled points
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Preview", meta=(ClampMin="1"))
+	int32 MaxPreviewInstances = 20000;
+
+	// Generate tiles around the players at runtime instead of using baked instances.
+	// Needs TiledBridson or BlueNoiseTiles sampling, baked instances are cleared on BeginPlay.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming")
+	bool bStreamAtRuntime = false;
+
+	// Tiles closer than this to a view are generated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(ClampMin="0.0", EditCondition="bStreamAtRuntime"))
+	float StreamingRadius = 20000.0f;
+
+	// Extra distance before a generated tile is released, avoids churn at the radius
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(ClampMin="0.0", EditCondition="bStreamAtRuntime"))
+	float StreamingReleaseMargin = 5000.0f;
+
+	// Game thread time spent per frame applying and releasing tiles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(ClampMin="0.1", EditCondition="bStreamAtRuntime"))
+	float StreamingFrameBudgetMs = 2.0f;
+
+	// Tiles sampled and projected on worker threads at the same time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(ClampMin="1", EditCondition="bStreamAtRuntime"))
+	int32 MaxStreamingTasks = 2;
+
+	// Reuse the points of an earlier generation with the same inputs, stored in Saved/ProceduralPlacementCache.
+	// The key covers the collision under the zone: transforms, bounds and meshes of the primitives the
+	// projection rays can hit, and the landscape heights in heightfield mode.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Cache")
+	bool bUsePointCache = true;
+
+	UPROPERTY(NonTransactional)
 	TArray<FVector> SplinePoints;
+
+	// XY bounds of SplinePoints, rebuilt by CacheSpline
+	FBox SplineBounds = FBox(ForceInit);
+
+	// Area enclosed by SplinePoints, rebuilt by CacheSpline
+	double ZoneArea = 0.0;
 	
+	// Containment index over SplinePoints, rebuilt by CacheSpline
+	FSplinePolygonIndex PolygonIndex;
+
+	// Holes of ExclusionSplines and ExclusionActors, rebuilt by CacheSpline
+	FPlacementExclusionIndex Exclusions;
+
+	// Landscape heights under the zone, built by PrepareProjection in heightfield mode or for slope density
+	FLandscapeHeightSnapshot HeightSnapshot;
+
+	// Min (X) and max (Y) heights of the projection rays, set by PrepareProjection.
+	// Projection workers only read this copy.
+	FVector2D ProjectionHeightRange = FVector2D::ZeroVector;
+
+	// Local spacing of a variable density zone, built by PrepareProjection, empty otherwise
+	FPlacementSpacingMap SpacingMap;
+
+	// Points of the lower layers of LayerGroup, built by PrepareProjection, null when there are none
+	TSharedPtr<const FPlacementLayerIndex> LayerIndex;
+
 	float GridX = 0.0f;
 	float GridY = 0.0f;
+
+	// Counts and timings of the last finished generation
+	UPROPERTY(VisibleAnywhere, Transient, Category="Stats")
+	FPlacementGenerationReport LastReport;
+
+	// Sampler counters of the last PoissonDiskAlgo call
+	FPlacementSamplingStats SamplingStats;
 	
 	UFUNCTION(BlueprintCallable, Category="Placement")
 	void Generate();
@@ -59,21 +367,165 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Placement")
 	void GenerateFunction();
 
+	// Samples and projects on a worker, then builds the instances on the game thread.
+	// For a preview the points go to the preview component and the ISMs are left alone.
+	void GenerateAsync(bool bPreview = false);
+
+	// Live preview: spline and parameter edits resample in the background once they stop for
+	// PreviewDelay, and a capped set of transient instances shows the result
+	UFUNCTION(BlueprintCallable, Category="Preview")
+	void StartLivePreview();
+
+	// Removes the preview instances, the ISMs keep their last committed state
+	UFUNCTION(BlueprintCallable, Category="Preview")
+	void StopLivePreview();
+
+	UFUNCTION(BlueprintPure, Category="Preview")
+	bool IsLivePreviewActive() const { return bLivePreview; }
+
+	// Builds the ISMs from the previewed points, or generates when the preview is out of date
+	UFUNCTION(BlueprintCallable, Category="Preview")
+	void CommitPreview();
+
+	// Resamples the preview once no other request came for PreviewDelay, does nothing without a live preview
+	void RequestPreview();
+
+	// Cancels the running generation, if any, and waits for its worker to stop
+	UFUNCTION(BlueprintCallable, Category="Placement")
+	void CancelGeneration();
+
+	UFUNCTION(BlueprintPure, Category="Placement")
+	bool IsGenerating() const;
+
+	// 0 to 1 while a generation is running
+	UFUNCTION(BlueprintPure, Category="Placement")
+	float GetGenerationProgress() const;
+
+	// Generates every zone of LayerGroup in LayerOrder, each one sampled against
+	// a single index holding the points of the layers before it
+	UFUNCTION(BlueprintCallable, CallInEditor, Category="Layers")
+	void GenerateLayerGroup();
+
+	// Zones of LayerGroup in this world, sorted by LayerOrder
+	void GetLayerZones(TArray<UProceduralPlacementComponent*>& OutZones) const;
+
+	// Deletes the cached point sets of every zone, the next generations run in full
+	UFUNCTION(BlueprintCallable, CallInEditor, Category="Cache")
+	void ClearPointCache();
+
+	// Hash of the spline, sampling and projection inputs, empty when the cache is off.
+	// Expects CacheSpline and PrepareProjection to have run.
+	FString GetPointCacheKey();
+
+	// Same hash whether the cache is on or not
+	FString GetInputsKey();
+
+	// Hashes the primitives the projection rays can hit, expects PrepareProjection to have run
+	void AddProjectionTargets(FBlake3& Hasher) const;
+
+	UFUNCTION(BlueprintPure, Category="Placement")
+	const FPlacementGenerationReport& GetLastReport() const { return LastReport; }
+
+	// Resamples the tiles whose inputs changed since the last generation and
+	// patches their instances, falls back to Generate when that is not possible
+	UFUNCTION(BlueprintCallable, Category="Placement")
+	void RegenerateChangedTiles();
+
+	// Sets DensityScale and adds or removes the tail instances to match
+	UFUNCTION(BlueprintCallable, Category="Instances")
+	void SetDensityScale(float NewDensityScale);
+
+	// Brings the instance count in line with the density scales, without resampling
+	void ApplyDensityScale();
+
+	// Instances kept out of NumPoints progressively ordered points
+	int32 GetDensityCount(int32 NumPoints) const;
+
+	// Reorders Points for bProgressiveOrder, does nothing when it is off
+	void OrderPointsProgressive(TArray<FVector>& Points) const;
+
+	// Mesh, or the palette entries with a mesh and a weight
+	bool HasMesh() const;
+
+	// Meshes of the palette in ISM order, with the running sum of their weights
+	void GetMeshes(TArray<UStaticMesh*>& OutMeshes, TArray<float>& OutCumulativeWeights) const;
+
+	// Spline->ISMComp first, then one component per further palette mesh
+	void GetInstanceComponents(TArray<UInstancedStaticMeshComponent*>& OutComponents) const;
+
+	// Removes the instances of every mesh
+	UFUNCTION(BlueprintCallable, Category="Placement")
+	void ClearInstances();
+
+	// Transforms of the first NumPoints points, grouped by the mesh each point picks.
+	// Salt is mixed into the pick, so streamed tiles do not all repeat the same sequence.
+	void SplitByMesh(TConstArrayView<FVector> Points, int32 NumPoints, uint32 Salt, TArray<TArray<FTransform>>& OutTransforms) const;
+
+	// Creates the ISMs on first use, otherwise clears them
+	void PrepareInstanceComponent();
+
 	UFUNCTION()
 	void ApplyPoints(const TArray<FVector>& Points);
+
+	// Adds one instance per entry of Positions, in one batched call or time sliced.
+	// OnSubmitted runs once the last instance is in.
+	// bAllowTimeSlicing false forces the single call whatever bTimeSliceInstances is.
+	void SubmitInstances(TFunction<void()> OnSubmitted = nullptr, bool bAllowTimeSlicing = true);
 	
 	// Points generation algorithm
 	UFUNCTION()
 	void PoissonDiskAlgo(TArray<FVector>& Points);
 
+	// Bridson with the radius of SpacingMap at each point, kept away from every point closer than its own radius
+	void PoissonDiskVariable(TArray<FVector>& Points);
+
+	// Tiled variant, output only depends on Seed and the tile layout
+	void PoissonDiskTiled(TArray<FVector>& Points);
+
+	void SampleTile(FPoissonSampleGrid& Grid, const FIntPoint& LocalTile, const FIntPoint& WorldTile, int32 TileCells, TArray<FVector>& OutPoints, FPlacementSamplingStats& OutStats) const;
+
+	void SampleTilesInPhases(FPoissonSampleGrid& Grid, const FIntPoint& GridFirstTile, TConstArrayView<FIntPoint> WorldTiles, TArray<TArray<FVector>>& OutPoints, FPlacementSamplingStats& OutStats) const;
+
+	// Stamps blue noise tiles over the zone, each world tile picks its variant from Seed
+	void PoissonDiskBlueNoise(TArray<FVector>& Points);
+
+	void StampBlueNoiseTile(const FIntPoint& WorldTile, TConstArrayView<FBlueNoiseTile> Tiles, double TileWorld, TArray<FVector>& OutPoints, FPlacementSamplingStats& OutStats) const;
+
+	void GetTileLayout(float& OutCellSize, int32& OutTileCells, double& OutTileWorld) const;
+
+	void InitTileGrid(FPoissonSampleGrid& Grid, const FIntPoint& FirstTile, const FIntPoint& LastTile) const;
+
+	static FIntPoint GetTileCoord(const FVector& Point, double TileWorld);
+
 	UFUNCTION()
 	void ProjectPoints();
 
-	UFUNCTION()
-	bool IsValid(FVector Candidate, TArray<FVector>& Points, FVector Max, FVector Min, float CellSIze, TArray<FGridCell> Grids);
+	// Builds what the projection mode needs before points get projected,
+	// limited to Region when given instead of the whole zone.
+	// For the whole zone the spacing map of the density source is built as well.
+	void PrepareProjection(const FBox2D* Region = nullptr);
+
+	void BuildSpacingMap();
+
+	void BuildLayerIndex();
+
+	FORCEINLINE bool IsBlockedByLayers(const FVector& Candidate) const
+	{
+		return LayerIndex && LayerIndex->IsBlocked(FVector2D(Candidate), LayerRadius);
+	}
+
+	// OutTotals, when given, receives the counts summed over every batch
+	void ProjectPointArray(TArray<FVector>& Points, FProjectionBatchStats* OutTotals = nullptr) const;
+
+	// Min (X) and max (Y) heights covered by projection rays, game thread only
+	FVector2D ComputeProjectionHeightRange() const;
+
+	bool IsValid(const FVector& Candidate, const FPoissonSampleGrid& Grid, int32& OutCellX, int32& OutCellY) const;
 
 	UFUNCTION()
-	bool IsInside(FVector Candidate);
+	bool IsInside(FVector Candidate) const;
+
+	void IsInsideBatch(TConstArrayView<FVector> Candidates, TBitArray<>& OutInside) const;
 
 	UFUNCTION()
 	FVector GetMinPoint();
@@ -83,4 +535,138 @@ public:
 
 	UFUNCTION()
 	void CacheSpline();
+
+	// World space polygon of a closed spline, tessellated like the zone outline
+	void GetSplinePolygon(USplineComponentPG* Source, TArray<FVector>& OutPoints) const;
+
+	void BuildExclusions();
+
+private:
+	void OnSplineModified();
+
+	void BindSplineEvents();
+	void UnbindSplineEvents();
+
+	// Buckets Positions into Tiles, expects instance i of the ISM to be Positions[i]
+	void RebuildTileCache();
+
+	void ComputeTileHashes(TConstArrayView<FIntPoint> WorldTiles, TArray<uint32>& OutHashes) const;
+
+	bool ShouldCancelGeneration() const;
+	void SetGenerationProgress(float Progress) const;
+	float GetSamplingProgress(int32 NumPoints) const;
+
+	// Submits the cached points of Key, false on a miss
+	bool SubmitCachedPoints(const FString& Key, FPlacementGenerationReport& Report, double StartTime);
+
+	// Fills the projection and instance counts, then makes Report the LastReport
+	void PublishReport(FPlacementGenerationReport& Report, const FProjectionBatchStats& Projection, double StartTime);
+
+	TSharedPtr<FPlacementGenerationTask> ActiveTask;
+	TSharedPtr<FPlacementInstanceBuilder> InstanceBuilder;
+
+	// Sorts each mesh's transforms by distance to the closest view rendered last frame.
+	// False when no view was rendered, Transforms are then left as they are.
+	bool SortNearestFirst(TArray<TArray<FTransform>>& Transforms) const;
+
+	// Set by SubmitInstances when the instances are not in Positions order
+	bool bInstancesReordered = false;
+
+	// Tiles of the last tiled generation and the layout they were built with
+	TMap<FIntPoint, FPlacementTile> Tiles;
+	float TileCacheCellSize = 0.0f;
+	int32 TileCacheTileCells = 0;
+
+	// Tiles of the asset, or of the default set when no asset is built, with their size in spacing units
+	const TArray<FBlueNoiseTile>& GetBlueNoiseTiles(float& OutTileSize);
+
+	TArray<FBlueNoiseTile> DefaultBlueNoiseTiles;
+
+	// Runtime streaming
+	void StartStreaming();
+	void StopStreaming();
+	void WaitForStreamingRequests();
+	void UpdateStreaming();
+	void CopyStreamedTileSettings(UInstancedStaticMeshComponent* Component) const;
+	void GetStreamingViews(TArray<FVector>& OutViews) const;
+	double GetStreamingTileWorld();
+
+	// Worker thread: sampled and projected points of one streaming tile
+	TArray<FVector> BuildStreamingTile(const FIntPoint& Tile);
+
+	// Unprojected points of a tile, identical to what PoissonDiskTiled produces for it.
+	// Earlier-phase neighbors are sampled first, as the phased sampler would have.
+	void GetSampledTile(const FIntPoint& Tile, TArray<FVector>& OutPoints);
+
+	bool bStreaming = false;
+	std::atomic<bool> bStopStreaming { false };
+
+	// SamplingMode as streamed, Bridson zones stream with TiledBridson
+	EPlacementSamplingMode StreamingSamplingMode = EPlacementSamplingMode::TiledBridson;
+
+	TArray<FPlacementStreamingRequest> StreamingRequests;
+
+	// Instance components per generated tile, so releasing a tile never reindexes others
+	UPROPERTY(Transient)
+	TMap<FIntPoint, FPlacementStreamedTile> StreamedTiles;
+
+	// Sampled tiles kept as constraints for their later-phase neighbors
+	TMap<FIntPoint, TArray<FVector>> SampledTileCache;
+	FCriticalSection SampledTileCacheLock;
+
+	// ISMs of the palette meshes after the first one, which uses Spline->ISMComp
+	UPROPERTY(NonTransactional)
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> PaletteComponents;
+
+	// Clears Component or creates it, and sets whether it is saved with the actor
+	UInstancedStaticMeshComponent* PrepareMeshComponent(UInstancedStaticMeshComponent* Component, UStaticMesh* ComponentMesh);
+
+	// Compact and streaming zones rebuild their instances from Positions instead of saving them
+	bool SavesInstanceComponents() const { return !bCompactStorage && !bStreamAtRuntime; }
+	void UpdateMeshComponentStorage(UInstancedStaticMeshComponent* Component) const;
+
+	// Positions as written to disk, only filled while saving or loading
+	UPROPERTY(NonTransactional)
+	FPlacementPointStorage StoredPositions;
+
+	// GeneratedPointsKey before an undo or redo, the instances are only rebuilt when it changes
+	FString KeyBeforeUndo;
+
+	// Rebuilds the instances of GeneratedPointsKey from the point cache, or generates them again
+	void RestoreGeneratedPoints();
+
+	// Set by GenerateLayerGroup, BuildLayerIndex takes it instead of building an index of its own
+	TSharedPtr<const FPlacementLayerIndex> SharedLayerIndex;
+
+	TWeakObjectPtr<USplineComponentPG> BoundSpline;
+	FDelegateHandle SplineModifiedHandle;
+
+	// Exclusion splines whose edits patch the zone like edits of Spline
+	TArray<TPair<TWeakObjectPtr<USplineComponentPG>, FDelegateHandle>> BoundExclusionSplines;
+
+	// Spline edit patches, the ticker is only registered while a patch is pending.
+	// It waits for the edits to stop and for any generation to finish.
+	bool TickTilePatch(float DeltaTime);
+
+	double TilePatchRequestTime = 0.0;
+	FTSTicker::FDelegateHandle TilePatchTickerHandle;
+
+	// Live preview
+	bool TickPreview(float DeltaTime);
+	void CancelPreviewTask();
+	void ShowPreview(TArray<FVector>&& Points, const FPlacementGenerationReport& Report, const FProjectionBatchStats& Projection);
+
+	bool bLivePreview = false;
+	bool bPreviewPending = false;
+	double PreviewRequestTime = 0.0;
+	FTSTicker::FDelegateHandle PreviewTickerHandle;
+
+	// Every point of the last preview and their inputs hash, copied into Positions by CommitPreview
+	TArray<FVector> PreviewPoints;
+	FString PreviewInputsKey;
+	FPlacementGenerationReport PreviewReport;
+	FProjectionBatchStats PreviewProjection;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> PreviewComponent;
 };
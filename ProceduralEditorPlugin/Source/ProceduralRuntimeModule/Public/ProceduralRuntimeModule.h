@@ -1 +1,8 @@
-#pragma once
\ No newline at end of file
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+PROCEDURALRUNTIMEMODULE_API DECLARE_LOG_CATEGORY_EXTERN(LogProceduralPlacement, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Procedural Placement"), STATGROUP_ProceduralPlacement, STATCAT_Advanced);
@@ -20,4 +20,24 @@ public :
 	UPROPERTY(VisibleAnywhere, Category = "Procedural")
 	UInstancedStaticMeshComponent* ISMComp;
 
+	virtual void UpdateSpline() override;
+
+	// Polyline following the curve within Tolerance (cm), in world space.
+	// The local tessellation is cached until the spline is modified.
+	void GetTessellatedPoints(float Tolerance, TArray<FVector>& OutPoints);
+
+	// Bumped every time the spline is modified
+	uint32 GetSplineRevision() const { return SplineRevision; }
+
+	// Broadcast after every modification of the spline
+	FSimpleMulticastDelegate OnSplineModified;
+
+private:
+	void Tessellate(float Tolerance);
+	void SubdivideSegment(float KeyA, float KeyB, const FVector& A, const FVector& B, float Tolerance, int32 Depth);
+
+	TArray<FVector> TessellatedPoints;
+	float TessellatedTolerance = -1.0f;
+	uint32 TessellatedRevision = 0;
+	uint32 SplineRevision = 1;
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Precomputed containment structure for a closed spline polygon.
+// A coarse raster mask classifies cells as fully inside, fully outside or crossed by
+// an edge. Only points landing in a boundary cell run the exact ray-crossing test,
+// and that test only walks the edges of the horizontal slab the point belongs to.
+
+struct PROCEDURALRUNTIMEMODULE_API FSplinePolygonIndex
+{
+	// Mask cells along the longest side of the polygon bounds
+	static constexpr int32 DefaultMaskResolution = 512;
+
+	void Build(const TArray<FVector>& Polygon, int32 MaskResolution = DefaultMaskResolution);
+	void Reset();
+
+	bool IsEmpty() const { return Edges.Num() == 0; }
+
+	bool IsInside(const FVector2D& Point) const;
+
+	// Tests many candidates at once, OutInside[i] matches Candidates[i]
+	void IsInsideBatch(TConstArrayView<FVector> Candidates, TBitArray<>& OutInside) const;
+
+	// Ray-crossing test restricted to the slab of the point, no mask lookup
+	bool IsInsideExact(const FVector2D& Point) const;
+
+private:
+	enum class ECellState : uint8
+	{
+		Outside,
+		Inside,
+		Boundary
+	};
+
+	struct FEdge
+	{
+		FVector2D P1;
+		FVector2D P2;
+	};
+
+	void BuildSlabs();
+	void BuildMask(int32 MaskResolution);
+	void MarkEdgeCells(const FEdge& Edge);
+
+	FORCEINLINE int32 GetSlab(double Y) const
+	{
+		return FMath::Clamp(FMath::FloorToInt32((Y - Bounds.Min.Y) / SlabHeight), 0, NumSlabs - 1);
+	}
+
+	TArray<FEdge> Edges;
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	// Edge lists per horizontal slab, stored as offsets into SlabEdges
+	int32 NumSlabs = 0;
+	double SlabHeight = 0.0;
+	TArray<int32> SlabStart;
+	TArray<int32> SlabEdges;
+
+	// Raster mask over Bounds
+	double CellSize = 0.0;
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<ECellState> Cells;
+};